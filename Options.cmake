@@ -1,7 +1,8 @@
 option(ANDROID_NDK_HOME "NDK path" C:/Users/<username>/AppData/Local/Android/Sdk/ndk/25.0.8775105)
 option(ANDROID_ABI "Android ABI" arm64-v8a)
-option(DEBUG_OUTPUT "Enable debug output" OFF)
+option(DEBUG_OUTPUT "Enable debug output by default, it can also be enabled at runtime from the log level file" OFF)
+option(HOST_BUILD "Build the hook library and the gesture engine for the host (x86-64 Linux) instead of Android" OFF)
 if (DEBUG_OUTPUT)
     add_definitions(-DDEBUG_OUTPUT)
-    message(NOTICE "- Debug output is enabled")
+    message(NOTICE "- Debug output is enabled by default")
 endif ()
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+// Helpers of the host benchmarks. They are plain executables that print one line per case, the numbers
+// only compare within one run on one machine.
+
+// Keeps `value` and everything it was computed from, without costing more than a register move.
+template<typename T>
+inline void keep(const T &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Runs `body(i)` for i in [0, iterations) after a warm-up of a tenth as many calls, and prints and returns
+// the mean time of one call in nanoseconds.
+template<typename Body>
+double runBench(const char *name, uint64_t iterations, Body &&body) {
+    for (uint64_t i = 0; i < iterations / 10; ++i) body(i);
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; ++i) body(i);
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    double perCall = elapsed.count() / static_cast<double>(iterations);
+    printf("%-40s %10.2f ns\n", name, perCall);
+    return perCall;
+}
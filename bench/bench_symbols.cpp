@@ -0,0 +1,10 @@
+// 512 exported functions named stubSymbol000 to stubSymbol777 (octal), a symbol table for the lookup
+// benchmark. Built without a build-id, so the resolver's RVA cache always misses on it.
+#define STUB_SYMBOL(n) extern "C" int stubSymbol##n() { return 0##n; }
+#define STUB_SYMBOLS8(n) STUB_SYMBOL(n##0) STUB_SYMBOL(n##1) STUB_SYMBOL(n##2) STUB_SYMBOL(n##3) \
+    STUB_SYMBOL(n##4) STUB_SYMBOL(n##5) STUB_SYMBOL(n##6) STUB_SYMBOL(n##7)
+#define STUB_SYMBOLS64(n) STUB_SYMBOLS8(n##0) STUB_SYMBOLS8(n##1) STUB_SYMBOLS8(n##2) STUB_SYMBOLS8(n##3) \
+    STUB_SYMBOLS8(n##4) STUB_SYMBOLS8(n##5) STUB_SYMBOLS8(n##6) STUB_SYMBOLS8(n##7)
+
+STUB_SYMBOLS64(0) STUB_SYMBOLS64(1) STUB_SYMBOLS64(2) STUB_SYMBOLS64(3)
+STUB_SYMBOLS64(4) STUB_SYMBOLS64(5) STUB_SYMBOLS64(6) STUB_SYMBOLS64(7)
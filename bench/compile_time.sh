@@ -0,0 +1,60 @@
+#!/bin/bash
+# Compile time of logging enum names with the constexpr tables of enum_names.h against magic_enum, which they
+# replaced. magic_enum.hpp is taken from the git history, so run this from a clone. Each translation unit names
+# the three scoped enums of enums.h the way hooks.cpp logs them, and is compiled RUNS times at -O2 and at
+# -O0 -g. Prints the median wall time and the preprocessed size of each.
+#
+#   bench/compile_time.sh [compiler]    default: $CXX, or c++
+set -euo pipefail
+
+CXX=${1:-${CXX:-c++}}
+RUNS=5
+REPO=$(git -C "$(dirname "$0")" rev-parse --show-toplevel)
+SRC=$REPO/input_inject/src
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+removed=$(git -C "$REPO" log -1 --format=%H --diff-filter=D -- input_inject/src/magic_enum.hpp)
+git -C "$REPO" show "$removed^:input_inject/src/magic_enum.hpp" > "$WORK/magic_enum.hpp"
+
+cat > "$WORK/tables.cpp" <<'CPP'
+#include <cstdio>
+#include "enum_names.h"
+
+void logNames(PointerGestureMode mode, ToolType type, MotionClassification classification) {
+    printf("%s %s %s\n", enums::name(mode), enums::name(type), enums::name(classification));
+}
+CPP
+
+cat > "$WORK/magic_enum.cpp" <<'CPP'
+#include <cstdio>
+#include <string>
+#include "enums.h"
+#include "magic_enum.hpp"
+
+void logNames(PointerGestureMode mode, ToolType type, MotionClassification classification) {
+    printf("%s %s %s\n", std::string(magic_enum::enum_name(mode)).c_str(),
+           std::string(magic_enum::enum_name(type)).c_str(),
+           std::string(magic_enum::enum_name(classification)).c_str());
+}
+CPP
+
+# median of RUNS compiles of $1 with the remaining arguments as flags, in ms
+compileMs() {
+    local source=$1
+    shift
+    for _ in $(seq "$RUNS"); do
+        local start end
+        start=$(date +%s%N)
+        "$CXX" -std=c++20 -fno-exceptions -fno-rtti "$@" -I"$WORK" -I"$SRC" -c "$source" -o "$WORK/out.o"
+        end=$(date +%s%N)
+        echo $(((end - start) / 1000000))
+    done | sort -n | sed -n "$(((RUNS + 1) / 2))p"
+}
+
+printf "%-24s %10s %10s %16s\n" "" "-O2" "-O0 -g" "preprocessed"
+for unit in tables magic_enum; do
+    lines=$("$CXX" -std=c++20 -E -I"$WORK" -I"$SRC" "$WORK/$unit.cpp" | wc -l)
+    printf "%-24s %7d ms %7d ms %10d lines\n" "$unit.cpp" "$(compileMs "$WORK/$unit.cpp" -O2)" \
+        "$(compileMs "$WORK/$unit.cpp" -O0 -g)" "$lines"
+done
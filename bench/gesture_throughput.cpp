@@ -0,0 +1,73 @@
+// Events per second through GestureEngine against the handlers it was extracted from, see
+// tests/reference_handlers.h, on the same pre-generated stream of touchpad reports.
+#include <cstdlib>
+#include <vector>
+#include "bench.h"
+#include "gesture_engine.h"
+#include "logger.h"
+#include "reference_handlers.h"
+
+namespace {
+
+    constexpr size_t STREAM_SIZE = 1 << 16;
+    constexpr uint64_t ITERATIONS = 20'000'000;
+
+    // gestures of a few dozen reports 8 ms apart: hovers, swipes, taps, clicks and two finger presses
+    std::vector<gesture::Input> stream(bool swipes) {
+        static constexpr PointerGestureMode MODES[] = {
+                PointerGestureMode::HOVER, PointerGestureMode::SWIPE, PointerGestureMode::TAP,
+                PointerGestureMode::BUTTON_CLICK_OR_DRAG, PointerGestureMode::PRESS, PointerGestureMode::NEUTRAL};
+        std::vector<gesture::Input> events;
+        srand(5);
+        nsecs_t when = 0;
+        float x = 500, y = 500;
+        while (events.size() < STREAM_SIZE) {
+            PointerGestureMode mode = MODES[rand() % 6];
+            if (!swipes && mode == PointerGestureMode::SWIPE) mode = PointerGestureMode::HOVER;
+            int reports = 1 + rand() % 40;
+            uint32_t fingers = mode == PointerGestureMode::SWIPE || mode == PointerGestureMode::PRESS ? 2 : 1;
+            float dx = static_cast<float>(rand() % 21 - 10), dy = static_cast<float>(rand() % 21 - 10);
+            for (int i = 0; i < reports && events.size() < STREAM_SIZE; ++i) {
+                when += 8000000;
+                x += dx;
+                y += dy;
+                events.push_back({when, mode, fingers, x, y, AMOTION_EVENT_ACTION_HOVER_MOVE, 0, 0});
+            }
+        }
+        return events;
+    }
+
+    void compare(const char *name, const std::vector<gesture::Input> &events) {
+        // time keeps going forward when the stream wraps around
+        auto at = [&](uint64_t i) {
+            gesture::Input in = events[i % STREAM_SIZE];
+            in.when += static_cast<nsecs_t>(i / STREAM_SIZE) * events.back().when;
+            return in;
+        };
+        char label[64];
+        gesture::GestureEngine engine;
+        gesture::Output out;
+        snprintf(label, sizeof(label), "GestureEngine::process, %s", name);
+        double engineNs = runBench(label, ITERATIONS, [&](uint64_t i) {
+            engine.process(at(i), config::DEFAULTS, out);
+            keep(out);
+        });
+        printf("%-40s %10.1f M events/s\n", label, 1e3 / engineNs);
+        ReferenceHandlers reference;
+        ReferenceHandlers::Calls calls;
+        snprintf(label, sizeof(label), "reference handlers, %s", name);
+        double referenceNs = runBench(label, ITERATIONS, [&](uint64_t i) {
+            reference.dispatchMotion(at(i), calls);
+            keep(calls);
+        });
+        printf("%-40s %10.1f M events/s\n", label, 1e3 / referenceNs);
+    }
+}
+
+int main() {
+    logger::disable("*");
+    // the engine fits a velocity over the recent reports of a swipe where the handlers took one delta
+    compare("all gestures", stream(true));
+    compare("no swipes", stream(false));
+    return 0;
+}
@@ -0,0 +1,26 @@
+// Cost of one call of a hooked function of the stub libinputreader.so: the patched jump, the THook entry
+// with its in-flight counter and bypass check, and the jump back into the original through the trampoline.
+#include "bench.h"
+#include "hookapi.h"
+#include "stub_inputreader.h"
+
+TInstanceHook(int64_t, hooks::LIBINPUT_READER, STUB_DISPATCH_MOTION, android::TouchInputMapper,
+              int64_t when, int32_t action) {
+    return original(this, when, action);
+}
+
+namespace {
+    constexpr uint64_t ITERATIONS = 50'000'000;
+}
+
+int main() {
+    android::TouchInputMapper mapper;
+    auto dispatch = [&](uint64_t i) { keep(mapper.dispatchMotion(static_cast<int64_t>(i), 1)); };
+
+    hooks::setBypass(true);
+    double unhooked = runBench("dispatchMotion, unhooked", ITERATIONS, dispatch);
+    hooks::setBypass(false);
+    double hooked = runBench("dispatchMotion, hooked", ITERATIONS, dispatch);
+    printf("%-40s %10.2f ns\n", "hook overhead per call", hooked - unhooked);
+    return 0;
+}
@@ -0,0 +1,89 @@
+// Cost of a log call on the calling thread, and how many records a flood drops. The sink is stderr on the
+// host, pointed at /dev/null here so that formatting and writing cost what they would without a terminal.
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "logger.h"
+
+#define LOG_TAG "InputInject/Bench"
+
+namespace {
+
+    constexpr uint64_t ITERATIONS = 2'000'000;
+    constexpr uint64_t FLOOD_RECORDS = 200'000;
+    // rounds of fewer records than a ring holds, with time for the drain thread to empty it in between
+    constexpr uint64_t ROUNDS = 100;
+    constexpr uint64_t ROUND_RECORDS = 48;
+
+    // Mean time of `body(i)` when its record always fits in the ring, so only the queuing is timed.
+    template<typename Body>
+    void timeQueued(const char *name, Body &&body) {
+        std::chrono::duration<double, std::nano> elapsed{0};
+        for (uint64_t round = 0; round < ROUNDS; ++round) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            auto start = std::chrono::steady_clock::now();
+            for (uint64_t i = 0; i < ROUND_RECORDS; ++i) body(i);
+            elapsed += std::chrono::steady_clock::now() - start;
+        }
+        printf("%-40s %10.2f ns\n", name, elapsed.count() / (ROUNDS * ROUND_RECORDS));
+    }
+}
+
+int main() {
+    if (freopen("/dev/null", "w", stderr) == nullptr) return 1;
+
+    logger::disable("*");
+    runBench("LOGD, level disabled", ITERATIONS * 10, [](uint64_t i) {
+        LOGD("dispatchMotion(deviceId=%d when=%lld)", 3, static_cast<long long>(i));
+    });
+    logger::setLevel("*", logger::LogLevel::DEBUG);
+    // past the burst of its site almost every call is counted as suppressed instead
+    runBench("LOGI, over the rate limit", ITERATIONS, [](uint64_t i) {
+        LOGI("dispatchMotion(deviceId=%d when=%lld)", 3, static_cast<long long>(i));
+    });
+
+    uint64_t droppedBefore = logger::dropped();
+    timeQueued("logger::write, 2 ints", [](uint64_t i) {
+        logger::write(logger::LogLevel::INFO, LOG_TAG, "dispatchMotion(deviceId=%d when=%lld)", 3,
+                      static_cast<long long>(i));
+    });
+    timeQueued("logger::write, 2 ints and a string", [](uint64_t i) {
+        logger::write(logger::LogLevel::INFO, LOG_TAG, "configureInputDevice(deviceId=%d deviceName=%s) %lld", 3,
+                      "Xiaomi Touch", static_cast<long long>(i));
+    });
+    // what every call used to cost: formatting and the sink on the calling thread
+    timeQueued("snprintf + logger::log, 2 ints", [](uint64_t i) {
+        char message[1024];
+        snprintf(message, sizeof(message), "dispatchMotion(deviceId=%d when=%lld)", 3, static_cast<long long>(i));
+        logger::log(logger::LogLevel::INFO, LOG_TAG, message);
+    });
+    printf("%-40s %10llu\n", "dropped while timing",
+           static_cast<unsigned long long>(logger::dropped() - droppedBefore));
+
+    // a flood past any rate limit, from one and from four threads
+    for (unsigned threads : {1u, 4u}) {
+        droppedBefore = logger::dropped();
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> flooders;
+        for (unsigned t = 0; t < threads; ++t) {
+            flooders.emplace_back([] {
+                for (uint64_t i = 0; i < FLOOD_RECORDS; ++i) {
+                    logger::write(logger::LogLevel::INFO, LOG_TAG, "flood %llu", static_cast<unsigned long long>(i));
+                }
+            });
+        }
+        for (std::thread &flooder : flooders) flooder.join();
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        uint64_t dropped = logger::dropped() - droppedBefore;
+        char name[64];
+        snprintf(name, sizeof(name), "flood, %u thread(s), ns per call", threads);
+        printf("%-40s %10.2f\n", name, elapsed.count() / FLOOD_RECORDS);
+        snprintf(name, sizeof(name), "flood, %u thread(s), dropped", threads);
+        printf("%-40s %9.1f%%\n", name,
+               100.0 * static_cast<double>(dropped) / static_cast<double>(FLOOD_RECORDS * threads));
+    }
+    return 0;
+}
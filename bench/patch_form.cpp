@@ -0,0 +1,135 @@
+// Per-call cost of the forms a hooked function's entry can be patched with, on x86-64 and aarch64:
+// - a direct branch to the replacement when it is in reach: "JMP rel32" within 2 GB, "B" within 128 MB;
+// - a direct branch to an entry island next to the function, which jumps on with an absolute jump, which is
+//   what A64HookFunction does for a replacement out of reach;
+// - the absolute jump written over the entry itself, "JMP [RIP+0]" or "LDR X17 / BR X17", which is what
+//   it falls back to when there is no free page near the function.
+// The replacement is the same two instructions in every case, mapped near or far.
+#include <cstring>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <hook64/And64InlineHook.hpp>
+#include "HookMemory.h"
+#include "bench.h"
+
+#if defined(__x86_64__) || defined(__aarch64__)
+
+extern "C" int patchFormBaseline(int x);
+extern "C" int patchFormNear(int x);
+extern "C" int patchFormIsland(int x);
+extern "C" int patchFormAbsolute(int x);
+
+#if defined(__x86_64__)
+
+// identical functions, long enough for the 14-byte absolute jump to be written over them
+#define PATCH_FORM_FUNCTION(name) \
+    ".p2align 4\n" #name ":\n leal 1(%rdi), %eax\n ret\n .fill 12, 1, 0x90\n"
+
+namespace {
+
+    constexpr uintptr_t DIRECT_REACH = 0x7fffffffu;
+    // "lea eax, [rdi + 1]; ret"
+    const uint8_t REPLACEMENT[] = {0x8d, 0x47, 0x01, 0xc3};
+
+    size_t absoluteJump(uint8_t *patch, uintptr_t target) {
+        patch[0] = 0xff; // JMP [RIP+0]
+        patch[1] = 0x25;
+        memset(patch + 2, 0, 4);
+        memcpy(patch + 6, &target, sizeof(target));
+        return 14;
+    }
+
+    constexpr const char *DIRECT_NAME = "JMP rel32 to the replacement";
+    constexpr const char *ISLAND_NAME = "JMP rel32 to an island, JMP [RIP+0]";
+    constexpr const char *ABSOLUTE_NAME = "JMP [RIP+0] to the replacement";
+}
+
+#else
+
+// identical functions, long enough for "LDR X17; BR X17; .quad" to be written over them
+#define PATCH_FORM_FUNCTION(name) \
+    ".p2align 4\n" #name ":\n add w0, w0, #1\n ret\n nop\n nop\n nop\n nop\n"
+
+namespace {
+
+    constexpr uintptr_t DIRECT_REACH = 1u << 27;
+    // "ADD W0, W0, #1; RET"
+    const uint32_t REPLACEMENT[] = {0x11000400u, 0xd65f03c0u};
+
+    // the functions are 16-byte aligned, so the literal lands 8-byte aligned without a leading NOP
+    size_t absoluteJump(uint8_t *patch, uintptr_t target) {
+        const uint32_t code[] = {0x58000051u, 0xd61f0220u}; // LDR X17, #0x8; BR X17
+        memcpy(patch, code, sizeof(code));
+        memcpy(patch + sizeof(code), &target, sizeof(target));
+        return sizeof(code) + sizeof(target);
+    }
+
+    constexpr const char *DIRECT_NAME = "B to the replacement";
+    constexpr const char *ISLAND_NAME = "B to an island, LDR X17 / BR X17";
+    constexpr const char *ABSOLUTE_NAME = "LDR X17 / BR X17 to the replacement";
+}
+
+#endif
+
+asm(".text\n"
+    PATCH_FORM_FUNCTION(patchFormBaseline)
+    PATCH_FORM_FUNCTION(patchFormNear)
+    PATCH_FORM_FUNCTION(patchFormIsland)
+    PATCH_FORM_FUNCTION(patchFormAbsolute));
+
+namespace {
+
+    constexpr uint64_t ITERATIONS = 200'000'000;
+
+    // Maps a copy of REPLACEMENT at a page as close to `hint` as the kernel allows.
+    void *mapReplacement(uintptr_t hint) {
+        const size_t page = sysconf(_SC_PAGESIZE);
+        void *p = mmap(reinterpret_cast<void *>(hint & ~(page - 1)), page, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) return nullptr;
+        memcpy(p, REPLACEMENT, sizeof(REPLACEMENT));
+        mprotect(p, page, PROT_READ | PROT_EXEC);
+        __builtin___clear_cache(static_cast<char *>(p), static_cast<char *>(p) + sizeof(REPLACEMENT));
+        return p;
+    }
+
+    uintptr_t distance(const void *p, uintptr_t target) {
+        auto x = reinterpret_cast<uintptr_t>(p);
+        return x > target ? x - target : target - x;
+    }
+}
+
+int main() {
+    auto nearTarget = reinterpret_cast<uintptr_t>(&patchFormNear);
+    auto farTarget = reinterpret_cast<uintptr_t>(&patchFormIsland);
+    void *nearReplacement = mapReplacement(nearTarget + (64u << 20));
+    void *farReplacement = mapReplacement(farTarget + (16ull << 30));
+    if (nearReplacement == nullptr || distance(nearReplacement, nearTarget) >= DIRECT_REACH
+        || farReplacement == nullptr || distance(farReplacement, farTarget) < DIRECT_REACH) {
+        fprintf(stderr, "could not map the replacements at the distances needed\n");
+        return 1;
+    }
+    A64HookFunction(reinterpret_cast<void *>(&patchFormNear), nearReplacement, nullptr);
+    A64HookFunction(reinterpret_cast<void *>(&patchFormIsland), farReplacement, nullptr);
+    uint8_t patch[HOOK_MAX_PATCH];
+    size_t size = absoluteJump(patch, reinterpret_cast<uintptr_t>(farReplacement));
+    if (!HookPatchText(reinterpret_cast<void *>(&patchFormAbsolute), patch, size)) {
+        fprintf(stderr, "could not patch the absolute jump\n");
+        return 1;
+    }
+
+    runBench("unpatched", ITERATIONS, [](uint64_t i) { keep(patchFormBaseline(static_cast<int>(i))); });
+    runBench(DIRECT_NAME, ITERATIONS, [](uint64_t i) { keep(patchFormNear(static_cast<int>(i))); });
+    runBench(ISLAND_NAME, ITERATIONS, [](uint64_t i) { keep(patchFormIsland(static_cast<int>(i))); });
+    runBench(ABSOLUTE_NAME, ITERATIONS, [](uint64_t i) { keep(patchFormAbsolute(static_cast<int>(i))); });
+    return 0;
+}
+
+#else
+
+int main() {
+    printf("patch_form has no implementation for this architecture\n");
+    return 0;
+}
+
+#endif // defined(__x86_64__) || defined(__aarch64__)
@@ -0,0 +1,80 @@
+// Throughput of scanner::find over the largest executable segment of libstdc++, about the size of the text
+// of libinputreader.so, against a byte-by-byte search with the same wildcard semantics.
+#include <cstring>
+#include <link.h>
+#include "bench.h"
+#include "pattern_scanner.h"
+
+namespace {
+
+    constexpr uint64_t ITERATIONS = 50;
+
+    struct Text {
+        const uint8_t *begin = nullptr;
+        const uint8_t *end = nullptr;
+    };
+
+    int largestText(dl_phdr_info *info, size_t, void *data) {
+        auto text = static_cast<Text *>(data);
+        if (info->dlpi_name == nullptr || strstr(info->dlpi_name, "libstdc++") == nullptr) return 0;
+        for (ElfW(Half) i = 0; i < info->dlpi_phnum; ++i) {
+            const ElfW(Phdr) &phdr = info->dlpi_phdr[i];
+            if (phdr.p_type != PT_LOAD || (phdr.p_flags & PF_X) == 0) continue;
+            if (phdr.p_memsz > static_cast<size_t>(text->end - text->begin)) {
+                text->begin = reinterpret_cast<const uint8_t *>(info->dlpi_addr + phdr.p_vaddr);
+                text->end = text->begin + phdr.p_memsz;
+            }
+        }
+        return 1;
+    }
+
+    const uint8_t *findBytewise(const uint8_t *p, const uint8_t *end, const scanner::Pattern &pattern) {
+        for (; p + pattern.size <= end; ++p) {
+            size_t i = 0;
+            while (i < pattern.size && (p[i] & pattern.mask[i]) == pattern.bytes[i]) ++i;
+            if (i == pattern.size) return p;
+        }
+        return nullptr;
+    }
+}
+
+int main() {
+    Text text;
+    dl_iterate_phdr(largestText, &text);
+    if (text.begin == nullptr) {
+        fprintf(stderr, "libstdc++ is not loaded\n");
+        return 1;
+    }
+    const size_t size = text.end - text.begin;
+
+    // 16 bytes from near the end of the text, with two wildcards like a pattern over a relocated call
+    char spec[16 * 3];
+    const uint8_t *target = text.begin + size - size / 16;
+    for (size_t i = 0; i < 16; ++i) {
+        if (i == 5 || i == 6) {
+            snprintf(spec + i * 3, 4, "?? ");
+        } else {
+            snprintf(spec + i * 3, 4, "%02X ", target[i]);
+        }
+    }
+    spec[sizeof(spec) - 1] = '\0';
+    scanner::Pattern pattern;
+    scanner::parse(spec, &pattern);
+    const uint8_t *expected = findBytewise(text.begin, text.end, pattern);
+    if (scanner::find(text.begin, text.end, pattern) != expected) {
+        fprintf(stderr, "scanner::find disagrees with the bytewise search\n");
+        return 1;
+    }
+    const double scanned = static_cast<double>(expected - text.begin) / (1 << 20);
+    printf("scanning %.2f MB of %.2f MB of text for \"%s\"\n", scanned, static_cast<double>(size) / (1 << 20), spec);
+
+    double bytewise = runBench("bytewise", ITERATIONS, [&](uint64_t) {
+        keep(findBytewise(text.begin, text.end, pattern));
+    });
+    double vector = runBench("scanner::find", ITERATIONS, [&](uint64_t) {
+        keep(scanner::find(text.begin, text.end, pattern));
+    });
+    printf("%-40s %10.2f GB/s\n", "bytewise", scanned / 1024 / (bytewise / 1e9));
+    printf("%-40s %10.2f GB/s\n", "scanner::find", scanned / 1024 / (vector / 1e9));
+    return 0;
+}
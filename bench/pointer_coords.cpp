@@ -0,0 +1,48 @@
+// Cost of one PointerCoords axis access: the inline accessors of types.h against the same code called
+// through a function pointer, which is what the call through SymCall into libinput.so used to be.
+#include "bench.h"
+#include "types.h"
+
+namespace {
+
+    constexpr uint64_t ITERATIONS = 50'000'000;
+
+    __attribute__((noinline)) float outOfLineGet(const PointerCoords *coords, int32_t axis) {
+        return coords->getAxisValue(axis);
+    }
+
+    __attribute__((noinline)) status_t outOfLineSet(PointerCoords *coords, int32_t axis, float value) {
+        return coords->setAxisValue(axis, value);
+    }
+
+    // opaque to the optimizer like a symbol resolved at runtime
+    float (*volatile getThroughPointer)(const PointerCoords *, int32_t) = outOfLineGet;
+    status_t (*volatile setThroughPointer)(PointerCoords *, int32_t, float) = outOfLineSet;
+}
+
+int main() {
+    // X, Y and the two gesture offsets, as a touchpad swipe carries them
+    PointerCoords coords{};
+    coords.setAxisValue(AMOTION_EVENT_AXIS_X, 1);
+    coords.setAxisValue(AMOTION_EVENT_AXIS_Y, 2);
+    coords.setAxisValue(AMOTION_EVENT_AXIS_GESTURE_X_OFFSET, 3);
+    coords.setAxisValue(AMOTION_EVENT_AXIS_GESTURE_Y_OFFSET, 4);
+
+    runBench("get, inline", ITERATIONS, [&](uint64_t i) {
+        keep(&coords);
+        keep(coords.getAxisValue(static_cast<int32_t>(i & 1)));
+    });
+    runBench("get, through a pointer", ITERATIONS, [&](uint64_t i) {
+        keep(getThroughPointer(&coords, static_cast<int32_t>(i & 1)));
+    });
+    runBench("set, inline", ITERATIONS, [&](uint64_t i) {
+        keep(coords.setAxisValue(AMOTION_EVENT_AXIS_GESTURE_X_OFFSET + static_cast<int32_t>(i & 1),
+                                 static_cast<float>(i)));
+        keep(&coords);
+    });
+    runBench("set, through a pointer", ITERATIONS, [&](uint64_t i) {
+        keep(setThroughPointer(&coords, AMOTION_EVENT_AXIS_GESTURE_X_OFFSET + static_cast<int32_t>(i & 1),
+                               static_cast<float>(i)));
+    });
+    return 0;
+}
@@ -0,0 +1,53 @@
+// Cost of one scroll speed lookup: gesture::scrollSpeed on the default curve against the stepped speed
+// transform of the old handleSwipeGesture, over velocities that sweep all of the curve.
+#include <cmath>
+#include <cstdlib>
+#include <utility>
+#include "bench.h"
+#include "gesture_engine.h"
+
+namespace {
+
+    constexpr uint64_t ITERATIONS = 100'000'000;
+    constexpr size_t VELOCITY_COUNT = 4096;
+
+    float oldSpeed(float speed) {
+        float s = std::fabs(speed);
+        float sign = speed > 0 ? 1.0f : -1.0f;
+        if (s < 0.2) return 0;
+        if (s < 0.5) return sign * (s * 1.1f);
+        if (s < 2) return sign * (s * 1.25f);
+        if (s > 80) return sign * 8.0f;
+        return sign * 2.5f;
+    }
+}
+
+int main() {
+    // px/ms, both directions, a little past the end of the curve; in px per report for the old transform
+    float velocities[VELOCITY_COUNT], deltas[VELOCITY_COUNT];
+    for (size_t i = 0; i < VELOCITY_COUNT; ++i) {
+        float t = static_cast<float>(i) / VELOCITY_COUNT * 2 - 1;
+        velocities[i] = t * std::fabs(t) * 14.0f;
+        deltas[i] = velocities[i] * config::REPORT_PERIOD_MS;
+    }
+    runBench("gesture::scrollSpeed, sweep", ITERATIONS, [&](uint64_t i) {
+        keep(gesture::scrollSpeed(velocities[i % VELOCITY_COUNT], config::DEFAULTS));
+    });
+    runBench("old stepped transform, sweep", ITERATIONS, [&](uint64_t i) {
+        keep(oldSpeed(deltas[i % VELOCITY_COUNT]));
+    });
+    // jumping around the curve, the branches of the old transform no longer predict
+    srand(1);
+    for (size_t i = VELOCITY_COUNT - 1; i > 0; --i) {
+        size_t j = static_cast<size_t>(rand()) % (i + 1);
+        std::swap(velocities[i], velocities[j]);
+        std::swap(deltas[i], deltas[j]);
+    }
+    runBench("gesture::scrollSpeed, random", ITERATIONS, [&](uint64_t i) {
+        keep(gesture::scrollSpeed(velocities[i % VELOCITY_COUNT], config::DEFAULTS));
+    });
+    runBench("old stepped transform, random", ITERATIONS, [&](uint64_t i) {
+        keep(oldSpeed(deltas[i % VELOCITY_COUNT]));
+    });
+    return 0;
+}
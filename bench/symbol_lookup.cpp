@@ -0,0 +1,47 @@
+// Cost of finding a symbol: dlsym against resolver::findSymbol, both the .gnu.hash walk of a module without
+// build-id and the build-id keyed cache hit that a warm start of the input service takes.
+#include <cstdint>
+#include <cstdio>
+#include <dlfcn.h>
+#include "bench.h"
+#include "stub_inputreader.h"
+#include "symbol_resolver.h"
+
+// referenced so that both libraries are linked in
+extern "C" int stubSymbol000();
+
+namespace {
+
+    constexpr uint64_t ITERATIONS = 2'000'000;
+    constexpr size_t SYMBOLS = 512;
+
+    char names[SYMBOLS][16];
+    uint32_t hashes[SYMBOLS];
+}
+
+int main() {
+    for (size_t i = 0; i < SYMBOLS; ++i) {
+        snprintf(names[i], sizeof(names[i]), "stubSymbol%03o", static_cast<unsigned>(i));
+        hashes[i] = resolver::gnuHash(names[i]);
+    }
+    keep(stubSymbol000());
+    keep(&android::TouchInputMapper::dispatchMotion);
+    void *handle = dlopen("libbench_symbols.so", RTLD_NOW | RTLD_NOLOAD);
+    if (handle == nullptr || resolver::findSymbol("libbench_symbols.so", names[7]) != dlsym(handle, names[7])) {
+        fprintf(stderr, "libbench_symbols.so is not loaded or resolves differently\n");
+        return 1;
+    }
+
+    // spread over the whole table, so neither side only hits the same cache lines
+    auto symbol = [](uint64_t i) { return (i * 97) % SYMBOLS; };
+    runBench("dlsym", ITERATIONS, [&](uint64_t i) { keep(dlsym(handle, names[symbol(i)])); });
+    runBench("findSymbol, .gnu.hash", ITERATIONS, [&](uint64_t i) {
+        size_t s = symbol(i);
+        keep(resolver::findSymbol("libbench_symbols.so", names[s], hashes[s]));
+    });
+    runBench("findSymbol, cached RVA", ITERATIONS, [](uint64_t) {
+        keep(resolver::findSymbol("libinputreader.so", STUB_DISPATCH_MOTION,
+                                  std::integral_constant<uint32_t, resolver::gnuHash(STUB_DISPATCH_MOTION)>::value));
+    });
+    return 0;
+}
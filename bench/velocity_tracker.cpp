@@ -0,0 +1,29 @@
+// Cost of what the swipe handler does with the tracker on every report, adding the sample and fitting the
+// velocity, at the report rates of common touchpads. The faster the rate, the more samples fall in the horizon.
+#include "bench.h"
+#include "velocity_tracker.h"
+
+namespace {
+
+    constexpr uint64_t ITERATIONS = 20'000'000;
+
+    void rate(const char *name, int hz) {
+        VelocityTracker tracker;
+        const nsecs_t period = 1000000000LL / hz;
+        float vx = 0, vy = 0;
+        runBench(name, ITERATIONS, [&](uint64_t i) {
+            auto t = static_cast<float>(i);
+            tracker.add(static_cast<nsecs_t>(i) * period, t * 3.0f, t * -1.5f);
+            keep(tracker.velocity(&vx, &vy));
+            keep(vx);
+            keep(vy);
+        });
+    }
+}
+
+int main() {
+    rate("add + velocity, 60 Hz (7 samples)", 60);
+    rate("add + velocity, 120 Hz (13 samples)", 120);
+    rate("add + velocity, 240 Hz (16 samples)", 240);
+    return 0;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fnmatch.h>
+
+// Which input devices get the touchpad gestures. A device is matched once, when its mapper is first
+// configured; from then on the mapper is tagged by its cloned vtable and dispatchMotion never looks at
+// the identifier again.
+namespace devices {
+
+    // The fields of InputDeviceIdentifier a rule can test.
+    struct Identity {
+        const char *name;
+        const char *location;
+        uint16_t bus;
+        uint16_t vendor;
+        uint16_t product;
+    };
+
+    // Every field a rule sets must match, a null string or a zero id matches anything.
+    struct Rule {
+        const char *name;     // exact device name
+        const char *location; // glob on the location, e.g. "usb-*/input0"
+        uint16_t bus;         // BUS_* from linux/input.h
+        uint16_t vendor;
+        uint16_t product;
+        float swipeMaxWidthRatio; // replaces the device's pointer gesture swipe ratio, 0 for the gesture config's
+    };
+
+    constexpr Rule RULES[] = {
+            {"Xiaomi Touch", nullptr, 0, 0, 0, 0.0f},
+    };
+
+    inline bool matches(const Rule &rule, const Identity &id) {
+        if (rule.name == nullptr && rule.location == nullptr && rule.bus == 0 && rule.vendor == 0 &&
+            rule.product == 0) {
+            return false; // an empty rule would take every device
+        }
+        return (rule.name == nullptr || strcmp(rule.name, id.name) == 0) &&
+               (rule.location == nullptr || fnmatch(rule.location, id.location, 0) == 0) &&
+               (rule.bus == 0 || rule.bus == id.bus) &&
+               (rule.vendor == 0 || rule.vendor == id.vendor) &&
+               (rule.product == 0 || rule.product == id.product);
+    }
+
+    // The first rule matching `id`, or nullptr.
+    inline const Rule *match(const Identity &id) {
+        for (const Rule &rule : RULES) {
+            if (matches(rule, id)) return &rule;
+        }
+        return nullptr;
+    }
+}
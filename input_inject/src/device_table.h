@@ -0,0 +1,71 @@
+#pragma once
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+
+// Fixed-capacity open-addressing map from an InputReader device id to per-device state.
+// Device ids are handed out sequentially, so the low bits of the id make a collision-free hash until the table
+// wraps around, and a lookup on the hot path is a single probe. Not thread-safe: only used on the reader thread.
+template<typename T, size_t Capacity>
+class DeviceTable {
+    static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+public:
+    struct Entry {
+        int32_t deviceId;
+        int32_t generation; // InputDevice::mGeneration the state belongs to
+        T value;
+    };
+
+    DeviceTable() {
+        for (auto &entry : entries) entry.deviceId = EMPTY;
+    }
+
+    Entry *find(int32_t deviceId) {
+        for (size_t i = slotOf(deviceId), n = 0; n < Capacity; i = (i + 1) & MASK, ++n) {
+            if (entries[i].deviceId == deviceId) return &entries[i];
+            if (entries[i].deviceId == EMPTY) return nullptr;
+        }
+        return nullptr;
+    }
+
+    // The entry of `deviceId`, added with a default value if it is new. Returns nullptr when the table is full.
+    Entry *insert(int32_t deviceId, int32_t generation) {
+        for (size_t i = slotOf(deviceId), n = 0; n < Capacity; i = (i + 1) & MASK, ++n) {
+            if (entries[i].deviceId == deviceId) return &entries[i];
+            if (entries[i].deviceId == EMPTY) {
+                entries[i].deviceId = deviceId;
+                entries[i].generation = generation;
+                entries[i].value = T();
+                return &entries[i];
+            }
+        }
+        return nullptr;
+    }
+
+    // Removes `deviceId` and shifts back the entries of its probe run, so no tombstones are needed.
+    void erase(int32_t deviceId) {
+        Entry *entry = find(deviceId);
+        if (entry == nullptr) return;
+        size_t hole = entry - entries;
+        entries[hole].deviceId = EMPTY;
+        for (size_t i = (hole + 1) & MASK; entries[i].deviceId != EMPTY; i = (i + 1) & MASK) {
+            size_t home = slotOf(entries[i].deviceId);
+            // move the entry into the hole unless its home slot lies cyclically after the hole
+            if (((i - home) & MASK) >= ((i - hole) & MASK)) {
+                entries[hole] = entries[i];
+                entries[i].deviceId = EMPTY;
+                hole = i;
+            }
+        }
+    }
+
+private:
+    static constexpr int32_t EMPTY = INT32_MIN; // the virtual keyboard has id -1, so not a negative id
+    static constexpr size_t MASK = Capacity - 1;
+
+    Entry entries[Capacity];
+
+    static inline size_t slotOf(int32_t deviceId) { return static_cast<uint32_t>(deviceId) & MASK; }
+};
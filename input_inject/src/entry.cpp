@@ -1,15 +1,71 @@
 #include <cstdint>
 #include <unistd.h>
+#include "gesture_config.h"
 #include "hookapi.h"
 #include "logger.h"
+#include "motion_recorder.h"
 
 #define LOG_TAG "InputInject/Entry"
 
+static void hook_install_begin() __attribute__((constructor(101)));
+
+static void symcall_resolve() __attribute__((constructor(102)));
+
 static void lib_entry() __attribute__((constructor));
 
 static_assert(sizeof(int64_t) == 8);
 
+void hook_install_begin() {
+    A64HookBegin();
+}
+
+// bounds of the SymCall table, provided by the linker. Not weak, so that a build whose compiler dropped
+// the section, see SymCallSlot, fails to link instead of resolving nothing.
+extern SymCallEntry __start_symcall_table[] __attribute__((visibility("hidden")));
+extern SymCallEntry __stop_symcall_table[] __attribute__((visibility("hidden")));
+
+// SymCall targets that could not be resolved, the hooks are not committed if there are any
+static size_t symcallsMissing = 0;
+
+size_t hooks::resolveSymCalls() {
+    size_t missing = 0;
+    for (SymCallEntry *entry = __start_symcall_table; entry < __stop_symcall_table; ++entry) {
+        entry->address = resolver::findSymbol(entry->module, entry->sym, entry->hash);
+        if (entry->address == nullptr) {
+            LOGE("SymCall target not found %s: %s", entry->module, entry->sym);
+            missing++;
+        }
+    }
+    return missing;
+}
+
+// Runs while the loader still holds its lock and before the hooks are committed, so no hook can race the table.
+void symcall_resolve() {
+    size_t count = __stop_symcall_table - __start_symcall_table;
+    if (count == 0) LOGE("the SymCall table is empty");
+    symcallsMissing = hooks::resolveSymCalls();
+    LOGI("resolved %zu/%zu SymCall targets", count - symcallsMissing, count);
+}
+
 void lib_entry() {
     logger::currentPid = getpid();
+    logger::watchLevels(INPUT_INJECT_LOG_LEVELS_PATH);
     LOGD("input injector begin, current pid = %d", logger::currentPid);
+    config::watch(INPUT_INJECT_CONFIG_PATH);
+    recorder::watch(INPUT_INJECT_RECORD_CONTROL_PATH);
+
+    // the hooks call into the SymCall targets, which do nothing when missing, so rather run without hooks
+    if (symcallsMissing != 0) {
+        A64HookAbort();
+        LOGE("%zu SymCall targets not found, no hooks installed", symcallsMissing);
+        return;
+    }
+    uint64_t elapsed_ns = 0;
+    int      patched    = A64HookCommit(&elapsed_ns);
+    LOGI("installed %d hooks in %llu us", patched, (unsigned long long) (elapsed_ns / 1000));
+    for (size_t i = 0; i < hooks::hookSiteCount; ++i) {
+        const hooks::HookSite &site = hooks::hookSites[i];
+        if (!A64IsHooked(site.address)) LOGE("hook not installed %s: %s", site.module, site.sym);
+    }
+    hooks::watchBypass(INPUT_INJECT_BYPASS_PATH);
 }
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "enums.h"
+
+// Names of the enums in enums.h for logging. Each table is built at compile time from a list of the enumerators
+// below and indexed by value, so a lookup is one bounds check and one load, and the names are string literals
+// that can be passed straight to %s. A value missing from a list, or out of range, is named "?".
+namespace enums {
+
+    template<size_t Size>
+    struct NameTable {
+        const char *names[Size]{};
+
+        constexpr const char *operator[](size_t value) const {
+            return value < Size && names[value] != nullptr ? names[value] : "?";
+        }
+    };
+
+#define INPUT_INJECT_POINTER_GESTURE_MODES(ENTRY) \
+    ENTRY(NEUTRAL) ENTRY(TAP) ENTRY(TAP_DRAG) ENTRY(BUTTON_CLICK_OR_DRAG) ENTRY(HOVER) ENTRY(PRESS) ENTRY(SWIPE) \
+    ENTRY(FREEFORM) ENTRY(QUIET)
+
+#define INPUT_INJECT_TOOL_TYPES(ENTRY) \
+    ENTRY(UNKNOWN) ENTRY(FINGER) ENTRY(STYLUS) ENTRY(MOUSE) ENTRY(ERASER) ENTRY(PALM)
+
+#define INPUT_INJECT_MOTION_CLASSIFICATIONS(ENTRY) \
+    ENTRY(NONE) ENTRY(AMBIGUOUS_GESTURE) ENTRY(DEEP_PRESS) ENTRY(TWO_FINGER_SWIPE) ENTRY(MULTI_FINGER_SWIPE) ENTRY(PINCH)
+
+// without their AMOTION_EVENT_ACTION_ prefix
+#define INPUT_INJECT_MOTION_ACTIONS(ENTRY) \
+    ENTRY(DOWN) ENTRY(UP) ENTRY(MOVE) ENTRY(CANCEL) ENTRY(OUTSIDE) ENTRY(POINTER_DOWN) ENTRY(POINTER_UP) \
+    ENTRY(HOVER_MOVE) ENTRY(SCROLL) ENTRY(HOVER_ENTER) ENTRY(HOVER_EXIT) ENTRY(BUTTON_PRESS) ENTRY(BUTTON_RELEASE)
+
+// without their AMOTION_EVENT_AXIS_ prefix
+#define INPUT_INJECT_MOTION_AXES(ENTRY) \
+    ENTRY(X) ENTRY(Y) ENTRY(PRESSURE) ENTRY(SIZE) ENTRY(TOUCH_MAJOR) ENTRY(TOUCH_MINOR) ENTRY(TOOL_MAJOR) \
+    ENTRY(TOOL_MINOR) ENTRY(ORIENTATION) ENTRY(VSCROLL) ENTRY(HSCROLL) ENTRY(Z) ENTRY(RX) ENTRY(RY) ENTRY(RZ) \
+    ENTRY(HAT_X) ENTRY(HAT_Y) ENTRY(LTRIGGER) ENTRY(RTRIGGER) ENTRY(THROTTLE) ENTRY(RUDDER) ENTRY(WHEEL) ENTRY(GAS) \
+    ENTRY(BRAKE) ENTRY(DISTANCE) ENTRY(TILT) ENTRY(SCROLL) ENTRY(RELATIVE_X) ENTRY(RELATIVE_Y) ENTRY(GENERIC_1) \
+    ENTRY(GENERIC_2) ENTRY(GENERIC_3) ENTRY(GENERIC_4) ENTRY(GENERIC_5) ENTRY(GENERIC_6) ENTRY(GENERIC_7) \
+    ENTRY(GENERIC_8) ENTRY(GENERIC_9) ENTRY(GENERIC_10) ENTRY(GENERIC_11) ENTRY(GENERIC_12) ENTRY(GENERIC_13) \
+    ENTRY(GENERIC_14) ENTRY(GENERIC_15) ENTRY(GENERIC_16) ENTRY(GESTURE_X_OFFSET) ENTRY(GESTURE_Y_OFFSET) \
+    ENTRY(GESTURE_SCROLL_X_DISTANCE) ENTRY(GESTURE_SCROLL_Y_DISTANCE) ENTRY(GESTURE_PINCH_SCALE_FACTOR)
+
+    // The entries name the enumerators themselves, so a misspelt or removed one does not compile, and each name
+    // lands at its enumerator's value whatever the order of the list.
+#define INPUT_INJECT_NAME_AT(value, name) table.names[static_cast<size_t>(value)] = name;
+#define INPUT_INJECT_SCOPED_NAME(name) INPUT_INJECT_NAME_AT(ENUM::name, #name)
+#define INPUT_INJECT_ACTION_NAME(name) INPUT_INJECT_NAME_AT(AMOTION_EVENT_ACTION_##name, #name)
+#define INPUT_INJECT_AXIS_NAME(name) INPUT_INJECT_NAME_AT(AMOTION_EVENT_AXIS_##name, #name)
+
+    constexpr auto POINTER_GESTURE_MODE_NAMES = [] {
+        using ENUM = PointerGestureMode;
+        NameTable<static_cast<size_t>(ENUM::QUIET) + 1> table;
+        INPUT_INJECT_POINTER_GESTURE_MODES(INPUT_INJECT_SCOPED_NAME)
+        return table;
+    }();
+
+    constexpr auto TOOL_TYPE_NAMES = [] {
+        using ENUM = ToolType;
+        NameTable<static_cast<size_t>(ENUM::ftl_last) + 1> table;
+        INPUT_INJECT_TOOL_TYPES(INPUT_INJECT_SCOPED_NAME)
+        return table;
+    }();
+
+    constexpr auto MOTION_CLASSIFICATION_NAMES = [] {
+        using ENUM = MotionClassification;
+        NameTable<static_cast<size_t>(ENUM::PINCH) + 1> table;
+        INPUT_INJECT_MOTION_CLASSIFICATIONS(INPUT_INJECT_SCOPED_NAME)
+        return table;
+    }();
+
+    constexpr auto MOTION_ACTION_NAMES = [] {
+        NameTable<AMOTION_EVENT_ACTION_BUTTON_RELEASE + 1> table;
+        INPUT_INJECT_MOTION_ACTIONS(INPUT_INJECT_ACTION_NAME)
+        return table;
+    }();
+
+    constexpr auto MOTION_AXIS_NAMES = [] {
+        NameTable<AMOTION_EVENT_MAXIMUM_VALID_AXIS_VALUE + 1> table;
+        INPUT_INJECT_MOTION_AXES(INPUT_INJECT_AXIS_NAME)
+        return table;
+    }();
+
+#undef INPUT_INJECT_NAME_AT
+#undef INPUT_INJECT_SCOPED_NAME
+#undef INPUT_INJECT_ACTION_NAME
+#undef INPUT_INJECT_AXIS_NAME
+
+    constexpr const char *name(PointerGestureMode mode) {
+        return POINTER_GESTURE_MODE_NAMES[static_cast<size_t>(mode)];
+    }
+
+    constexpr const char *name(ToolType type) {
+        return TOOL_TYPE_NAMES[static_cast<size_t>(type)];
+    }
+
+    constexpr const char *name(MotionClassification classification) {
+        return MOTION_CLASSIFICATION_NAMES[static_cast<size_t>(classification)];
+    }
+
+    // Name of the action of a motion event action code, the pointer index bits are ignored.
+    constexpr const char *actionName(int32_t action) {
+        return MOTION_ACTION_NAMES[static_cast<size_t>(action & AMOTION_EVENT_ACTION_MASK)];
+    }
+
+    constexpr const char *axisName(int32_t axis) {
+        return MOTION_AXIS_NAMES[static_cast<uint32_t>(axis)];
+    }
+}
@@ -0,0 +1,168 @@
+#include "file_watcher.h"
+
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include "logger.h"
+
+#define LOG_TAG "InputInject/Watcher"
+
+namespace {
+
+    struct WatchedFile {
+        char path[256];
+        const char *name; // inside path
+        int wd;
+        watcher::Callback onChange;
+    };
+
+    WatchedFile files[watcher::MAX_FILES];
+    unsigned fileCount = 0;
+    watcher::Tick ticks[watcher::MAX_TICKS];
+    unsigned tickCount = 0;
+    std::mutex filesLock;
+    std::once_flag startOnce;
+    int inotifyFd = -1;
+    int wakeFd = -1; // written by tick() so that the thread picks up the new tick
+
+    // Adds `onTick` unless it is pending already, under filesLock.
+    bool addTick(watcher::Tick onTick) {
+        for (unsigned i = 0; i < tickCount; ++i) {
+            if (ticks[i] == onTick) return true;
+        }
+        if (tickCount == watcher::MAX_TICKS) return false;
+        ticks[tickCount++] = onTick;
+        return true;
+    }
+
+    // Runs the pending ticks without the lock, a tick may add ticks or files.
+    void runTicks() {
+        watcher::Tick pending[watcher::MAX_TICKS];
+        unsigned pendingCount;
+        {
+            std::lock_guard<std::mutex> guard(filesLock);
+            pendingCount = tickCount;
+            memcpy(pending, ticks, sizeof(ticks[0]) * tickCount);
+            tickCount = 0;
+        }
+        for (unsigned i = 0; i < pendingCount; ++i) {
+            if (pending[i]()) {
+                std::lock_guard<std::mutex> guard(filesLock);
+                addTick(pending[i]);
+            }
+        }
+    }
+
+    void *watchLoop(void *) {
+        pthread_setname_np(pthread_self(), "InputInjectWatch");
+        alignas(inotify_event) char buffer[4096];
+        for (;;) {
+            int timeout;
+            {
+                std::lock_guard<std::mutex> guard(filesLock);
+                timeout = tickCount != 0 ? watcher::TICK_INTERVAL_MS : -1;
+            }
+            pollfd fds[] = {{inotifyFd, POLLIN, 0}, {wakeFd, POLLIN, 0}};
+            int ready = poll(fds, 2, timeout);
+            if (ready < 0 && errno == EINTR) continue;
+            uint64_t wakeups;
+            if ((fds[1].revents & POLLIN) && read(wakeFd, &wakeups, sizeof(wakeups)) < 0) {
+                LOGW("eventfd read failed (errno=%d)", errno);
+            }
+            if (ready >= 0 && !(fds[0].revents & POLLIN)) {
+                runTicks();
+                continue;
+            }
+            ssize_t n = ready < 0 ? -1 : read(inotifyFd, buffer, sizeof(buffer));
+            if (n <= 0) {
+                if (n < 0 && errno == EINTR) continue;
+                LOGE("inotify read failed (errno=%d), control files are no longer watched", errno);
+                return nullptr;
+            }
+            // collect first, so callbacks run without the lock and each at most once per batch
+            WatchedFile changed[watcher::MAX_FILES];
+            unsigned changedCount = 0;
+            {
+                std::lock_guard<std::mutex> guard(filesLock);
+                for (unsigned i = 0; i < fileCount; ++i) {
+                    for (char *p = buffer; p < buffer + n;) {
+                        auto event = reinterpret_cast<inotify_event *>(p);
+                        p += sizeof(inotify_event) + event->len;
+                        if (event->wd == files[i].wd && event->len != 0 && strcmp(event->name, files[i].name) == 0) {
+                            changed[changedCount++] = files[i];
+                            break;
+                        }
+                    }
+                }
+            }
+            for (unsigned i = 0; i < changedCount; ++i) {
+                changed[i].onChange(changed[i].path);
+            }
+            runTicks();
+        }
+    }
+
+    void start() {
+        inotifyFd = inotify_init1(IN_CLOEXEC);
+        if (inotifyFd < 0) {
+            LOGW("inotify_init1 failed (errno=%d), control files are not watched", errno);
+            return;
+        }
+        wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (wakeFd < 0) {
+            LOGW("eventfd failed (errno=%d), control files are not watched", errno);
+            close(inotifyFd);
+            inotifyFd = -1;
+            return;
+        }
+        pthread_t thread;
+        if (pthread_create(&thread, nullptr, watchLoop, nullptr) == 0) {
+            pthread_detach(thread);
+        }
+    }
+}
+
+namespace watcher {
+
+    bool add(const char *path, Callback onChange) {
+        std::call_once(startOnce, start);
+        const char *slash = strrchr(path, '/');
+        if (inotifyFd < 0 || slash == nullptr || strlen(path) >= sizeof(WatchedFile::path)) return false;
+
+        std::lock_guard<std::mutex> guard(filesLock);
+        if (fileCount == MAX_FILES) {
+            LOGW("cannot watch %s, all %u slots are taken", path, MAX_FILES);
+            return false;
+        }
+        WatchedFile &file = files[fileCount];
+        strcpy(file.path, path);
+        char dir[sizeof(file.path)];
+        memcpy(dir, path, slash - path);
+        dir[slash - path] = '\0';
+        file.name = file.path + (slash - path) + 1;
+        // watch the directory, so that the file can also be replaced by rename()
+        file.wd = inotify_add_watch(inotifyFd, dir, IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (file.wd < 0) {
+            LOGW("cannot watch %s (errno=%d)", dir, errno);
+            return false;
+        }
+        file.onChange = onChange;
+        fileCount++;
+        return true;
+    }
+
+    bool tick(Tick onTick) {
+        std::call_once(startOnce, start);
+        if (inotifyFd < 0) return false;
+        std::lock_guard<std::mutex> guard(filesLock);
+        if (!addTick(onTick)) return false;
+        // the thread may be blocked without a timeout
+        uint64_t one = 1;
+        return write(wakeFd, &one, sizeof(one)) == sizeof(one);
+    }
+}
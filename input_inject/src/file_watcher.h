@@ -0,0 +1,23 @@
+#pragma once
+
+// Change notification for the few control files of the library, all served by one inotify thread.
+namespace watcher {
+
+    using Callback = void (*)(const char *path);
+    // Returns true to be called again on the next tick.
+    using Tick = bool (*)();
+
+    // log levels, gesture config, recorder control and bypass take 4, the rest is headroom
+    constexpr unsigned MAX_FILES = 8;
+    constexpr unsigned MAX_TICKS = 4;
+    constexpr int TICK_INTERVAL_MS = 250;
+
+    // Calls `onChange` on the watcher thread whenever `path` is closed after writing or renamed into place.
+    // The directory of `path` must exist. Returns false if the file cannot be watched.
+    bool add(const char *path, Callback onChange);
+
+    // Calls `onTick` on the watcher thread every TICK_INTERVAL_MS or so until it returns false, for work that is
+    // due later, like freeing what a reader may still hold. The thread only wakes up while a tick is pending.
+    // Adding a pending tick again does nothing. Returns false if there is no watcher thread or no free slot.
+    bool tick(Tick onTick);
+}
@@ -0,0 +1,140 @@
+#include "fling.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <ctime>
+#include <mutex>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+#include "gesture_config.h"
+#include "gesture_engine.h"
+#include "logger.h"
+#include "spsc_ring.h"
+
+#define LOG_TAG "InputInject/Fling"
+
+namespace {
+
+    // Steps are produced at the usual display rate; the reader needs no more to look smooth.
+    constexpr long FRAME_INTERVAL_NS = 1000000000L / 60;
+
+    struct Command {
+        uint32_t id;
+        int32_t deviceId;
+        float vx, vy;
+        void (*wake)(void *);
+        void *context;
+    };
+
+    SpscRing<Command, 8> commands;   // reader -> fling thread
+    SpscRing<fling::Step, 64> steps; // fling thread -> reader
+
+    // id of the fling allowed to produce steps, 0 for none
+    std::atomic<uint32_t> current{0};
+    uint32_t lastId = 0; // reader thread only
+
+    std::once_flag threadOnce;
+    int timerFd = -1;
+
+    void arm(long delayNs) {
+        itimerspec spec{};
+        spec.it_value.tv_nsec = delayNs;
+        timerfd_settime(timerFd, 0, &spec, nullptr);
+    }
+
+    nsecs_t now() {
+        timespec ts{};
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    }
+
+    // The timer is one-shot and only re-armed by a tick that produced a step, so a fling that ended or was
+    // replaced simply stops ticking and no tick ever has to disarm it under a concurrent start().
+    void *flingLoop(void *) {
+        pthread_setname_np(pthread_self(), "InputInjectFling");
+        Command fling{};
+        nsecs_t lastTick = 0;
+        for (;;) {
+            uint64_t expirations;
+            if (read(timerFd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+                if (errno == EINTR) continue;
+                LOGE("timerfd read failed (errno=%d), flings stop", errno);
+                return nullptr;
+            }
+            nsecs_t tick = now();
+            for (Command command; commands.pop(&command);) {
+                fling = command;
+                lastTick = tick - FRAME_INTERVAL_NS;
+            }
+            if (fling.id == 0 || fling.id != current.load(std::memory_order_acquire)) continue;
+
+            const config::GestureConfig &config = config::current();
+            float dt = static_cast<float>(tick - lastTick) * 1e-6f;
+            lastTick = tick;
+            float decay = std::exp(-dt / config.flingTimeConstant);
+            fling.vx *= decay;
+            fling.vy *= decay;
+            if (std::hypot(fling.vx, fling.vy) < config.flingStopVelocity) {
+                uint32_t id = fling.id;
+                current.compare_exchange_strong(id, 0, std::memory_order_acq_rel);
+                fling.id = 0;
+                continue;
+            }
+            fling::Step step{fling.id, fling.deviceId,
+                             gesture::scrollSpeed(fling.vx, config) * dt * config.scrollScale,
+                             gesture::scrollSpeed(fling.vy, config) * dt * config.scrollScale};
+            if (steps.push(step)) {
+                fling.wake(fling.context);
+            }
+            arm(FRAME_INTERVAL_NS);
+        }
+    }
+
+    void startThread() {
+        timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+        if (timerFd < 0) {
+            LOGE("timerfd_create failed (errno=%d), flings are disabled", errno);
+            return;
+        }
+        pthread_t thread;
+        if (pthread_create(&thread, nullptr, flingLoop, nullptr) != 0) {
+            close(timerFd);
+            timerFd = -1;
+            return;
+        }
+        pthread_detach(thread);
+    }
+}
+
+namespace fling {
+
+    void start(int32_t deviceId, float vx, float vy, void (*wake)(void *), void *context) {
+        std::call_once(threadOnce, startThread);
+        if (timerFd < 0) return;
+        uint32_t id = ++lastId != 0 ? lastId : ++lastId;
+        if (!commands.push({id, deviceId, vx, vy, wake, context})) return;
+        current.store(id, std::memory_order_release);
+        arm(FRAME_INTERVAL_NS);
+        LOGD("start(id=%u deviceId=%d vx=%.3f vy=%.3f)", id, deviceId, vx, vy);
+    }
+
+    void cancel() {
+        current.store(0, std::memory_order_release);
+    }
+
+    bool pending() {
+        for (Step step; steps.peek(&step); steps.pop(&step)) {
+            if (step.id == current.load(std::memory_order_acquire)) return true;
+        }
+        return false;
+    }
+
+    bool poll(Step *step) {
+        while (steps.pop(step)) {
+            if (step->id == current.load(std::memory_order_acquire)) return true;
+        }
+        return false;
+    }
+}
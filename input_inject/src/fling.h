@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+// Inertial scrolling after a swipe. A fling decays on a timerfd thread of its own, which never touches
+// the reader: it queues scroll steps in a lock-free ring and wakes the reader, whose thread then dispatches
+// them. start(), cancel(), pending() and poll() must all be called on the InputReader thread.
+namespace fling {
+
+    struct Step {
+        uint32_t id;
+        int32_t deviceId;
+        float vscroll, hscroll; // same axes as the swipe scroll
+    };
+
+    // Starts a fling of `deviceId` at velocity (vx, vy) in px/ms, replacing any running one. `wake` is
+    // called on the fling thread after each queued step, to get the reader out of its wait.
+    void start(int32_t deviceId, float vx, float vy, void (*wake)(void *), void *context);
+
+    // Stops the running fling, steps already queued for it are dropped by poll().
+    void cancel();
+
+    // Whether a step of the running fling is queued. Drops the steps of earlier flings ahead of it.
+    bool pending();
+
+    // Next queued step of the running fling, false if there is none.
+    bool poll(Step *step);
+}
@@ -0,0 +1,127 @@
+#include "gesture_config.h"
+
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "file_watcher.h"
+#include "logger.h"
+
+#define LOG_TAG "InputInject/Config"
+
+namespace {
+
+    // A reader holds the config it loaded for one dispatchMotion call at most, so a replaced mapping is
+    // unmapped only after a delay that is orders of magnitude longer than that.
+    constexpr int64_t RETIRE_DELAY = 1000 * 1000000LL;
+    // far more reloads than anyone makes within RETIRE_DELAY, a mapping that does not fit is never unmapped
+    constexpr size_t MAX_RETIRED = 8;
+
+    struct Retired {
+        const config::GestureConfig *config;
+        int64_t deadline;
+    };
+
+    // Replaced mappings in the order they were replaced. Only touched by load() and the watcher's tick, which
+    // both run on the watcher thread once lib_entry's first load is done.
+    Retired retired[MAX_RETIRED];
+    size_t retiredCount = 0;
+
+    int64_t now() {
+        timespec ts{};
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    }
+
+    // Unmaps the retired mappings whose deadline passed, returns true while some are left.
+    bool unmapRetired() {
+        int64_t time = now();
+        size_t expired = 0;
+        while (expired < retiredCount && retired[expired].deadline <= time) {
+            munmap(const_cast<config::GestureConfig *>(retired[expired].config), sizeof(config::GestureConfig));
+            ++expired;
+        }
+        memmove(retired, retired + expired, (retiredCount - expired) * sizeof(Retired));
+        retiredCount -= expired;
+        return retiredCount != 0;
+    }
+
+    void retire(const config::GestureConfig *config) {
+        if (retiredCount == MAX_RETIRED) {
+            LOGW("too many gesture configs replaced at once, leaking one");
+            return;
+        }
+        retired[retiredCount++] = {config, now() + RETIRE_DELAY};
+        if (!watcher::tick(unmapRetired)) {
+            LOGW("no watcher tick, replaced gesture configs stay mapped");
+        }
+    }
+
+    void reload(const char *path) {
+        if (config::load(path)) {
+            LOGI("reloaded %s", path);
+        }
+    }
+}
+
+namespace config {
+
+    std::atomic<const GestureConfig *> active{&DEFAULTS};
+
+    bool validate(const GestureConfig &config, uint64_t fileSize) {
+        auto finite = [](float f) { return std::isfinite(f); };
+        if (fileSize != sizeof(GestureConfig) || config.magic != MAGIC || config.version != VERSION ||
+            config.size != sizeof(GestureConfig)) {
+            return false;
+        }
+        for (float speed : config.curve) {
+            if (!finite(speed)) return false;
+        }
+        return config.tapTimeout > 0 && config.tripleTapTimeout > 0 &&
+               finite(config.scrollScale) &&
+               config.swipeMaxWidthRatio > 0.0f && config.swipeMaxWidthRatio <= 1.0f &&
+               finite(config.curveMaxVelocity) && config.curveMaxVelocity > 0.0f &&
+               finite(config.flingTimeConstant) && config.flingTimeConstant >= 0.0f &&
+               finite(config.flingStopVelocity) && config.flingStopVelocity > 0.0f;
+    }
+
+    // Only called from lib_entry, before the watcher exists, and from the watcher, so loads never overlap.
+    bool load(const char *path) {
+        int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        struct stat st{};
+        if (fstat(fd, &st) != 0 || st.st_size != sizeof(GestureConfig)) {
+            LOGW("%s is not a gesture config of this version", path);
+            close(fd);
+            return false;
+        }
+        void *p = mmap(nullptr, sizeof(GestureConfig), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) return false;
+        // Dirty the page so the mapping owns a private copy: rewriting or truncating the file afterwards can
+        // then neither change the published config under a reader nor fault it with SIGBUS.
+        auto first = static_cast<volatile uint8_t *>(p);
+        *first = *first;
+        mprotect(p, sizeof(GestureConfig), PROT_READ);
+
+        auto config = static_cast<const GestureConfig *>(p);
+        if (!validate(*config, st.st_size)) {
+            LOGW("%s has invalid values, keeping the current gesture config", path);
+            munmap(p, sizeof(GestureConfig));
+            return false;
+        }
+        const GestureConfig *old = active.exchange(config, std::memory_order_acq_rel);
+        if (old != &DEFAULTS) retire(old);
+        return true;
+    }
+
+    void watch(const char *path) {
+        if (load(path)) {
+            LOGI("loaded %s", path);
+        }
+        if (!watcher::add(path, reload)) LOGE("cannot watch %s, changes are not picked up", path);
+    }
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+#ifndef INPUT_INJECT_CONFIG_PATH
+#if defined(__ANDROID__)
+#define INPUT_INJECT_CONFIG_PATH "/data/system/input_inject.gesture"
+#else
+#define INPUT_INJECT_CONFIG_PATH "/tmp/input_inject.gesture"
+#endif
+#endif
+
+// Tunables of the gesture transform, read from a binary file that is compiled from text by the host tool
+// gesture_config (input_inject/tools). The file is mapped as is, so the layout below is the file format:
+// little-endian, fixed size, and VERSION must be bumped on any change.
+namespace config {
+
+    constexpr uint32_t MAGIC = 0x43474949; // "IIGC"
+    constexpr uint32_t VERSION = 3;
+
+    // Samples of the scroll curve. They are spaced evenly in sqrt(velocity / curveMaxVelocity), so the slow end,
+    // where a finger resting on the pad jitters, gets most of the resolution.
+    constexpr size_t CURVE_SIZE = 64;
+
+    // A control point of the scroll curve: at `velocity` (px/ms) of the fingers, scroll `speed` units per ms.
+    struct CurvePoint {
+        float velocity;
+        float speed;
+    };
+
+    struct GestureConfig {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t size;               // sizeof(GestureConfig) of the writer
+        uint32_t reserved;
+        int64_t tapTimeout;          // ns, press to release of a tap
+        int64_t tripleTapTimeout;    // ns, between the three-finger taps that toggle the transform
+        float scrollScale;           // scroll axis units per unit of the curve
+        float swipeMaxWidthRatio;    // for devices whose rule does not set one
+        float curveMaxVelocity;      // px/ms of the last sample, faster swipes are clamped to it
+        float flingTimeConstant;     // ms for a fling to slow down to 1/e of its velocity, 0 disables flings
+        float flingStopVelocity;     // px/ms below which a fling ends, or does not start
+        float reserved2;
+        float curve[CURVE_SIZE];     // scroll speed at sample i, taken at velocity (i / (CURVE_SIZE - 1))^2 * max
+    };
+
+    static_assert(sizeof(GestureConfig) == 312);
+
+    // Velocity of sample `i` of a curve ending at `maxVelocity`.
+    constexpr float curveVelocityAt(size_t i, float maxVelocity) {
+        float t = static_cast<float>(i) / (CURVE_SIZE - 1);
+        return t * t * maxVelocity;
+    }
+
+    // Samples the piecewise linear curve through `points`, sorted by velocity, into `curve`. Below the first and
+    // above the last point the curve is flat, the last point's velocity becomes the curve's max velocity.
+    constexpr void sampleCurve(const CurvePoint *points, size_t count, float *curve) {
+        float maxVelocity = points[count - 1].velocity;
+        for (size_t i = 0; i < CURVE_SIZE; ++i) {
+            float v = curveVelocityAt(i, maxVelocity);
+            size_t k = 0;
+            while (k < count && points[k].velocity < v) ++k;
+            if (k == 0) {
+                curve[i] = points[0].speed;
+            } else if (k == count) {
+                curve[i] = points[count - 1].speed;
+            } else {
+                const CurvePoint &a = points[k - 1], &b = points[k];
+                curve[i] = a.speed + (b.speed - a.speed) * (v - a.velocity) / (b.velocity - a.velocity);
+            }
+        }
+    }
+
+    // The curve of the old per-event speed transform at a 120 Hz report rate: nothing below 0.2 px per report,
+    // gains of 1.1 and 1.25 up to 2 px, then 2.5 units per report, ramping up to 8 units at 100 px per report.
+    // Unlike the old steps it is continuous, which it deliberately differs in: it starts from 0 at 0.2 px where the
+    // old gain jumped to 0.22 units, and it rises from 2.5 units at 60 px to 8 at 100 px where the old transform
+    // jumped to 8 above 80 px. Elsewhere tests/scroll_curve_test keeps it within 0.12 units of the old transform.
+    constexpr float REPORT_PERIOD_MS = 1000.0f / 120;
+    constexpr CurvePoint DEFAULT_CURVE[] = {
+            {0.2f / REPORT_PERIOD_MS,  0.0f},
+            {0.5f / REPORT_PERIOD_MS,  0.55f / REPORT_PERIOD_MS},
+            {2.0f / REPORT_PERIOD_MS,  2.5f / REPORT_PERIOD_MS},
+            {60.0f / REPORT_PERIOD_MS, 2.5f / REPORT_PERIOD_MS},
+            {100.0f / REPORT_PERIOD_MS, 8.0f / REPORT_PERIOD_MS},
+    };
+
+    constexpr GestureConfig DEFAULTS = [] {
+        GestureConfig config{
+                MAGIC, VERSION, sizeof(GestureConfig), 0,
+                150 * 1000000LL,  // tapTimeout
+                1500 * 1000000LL, // tripleTapTimeout
+                0.2f,             // scrollScale
+                0.5f,             // swipeMaxWidthRatio
+                DEFAULT_CURVE[std::size(DEFAULT_CURVE) - 1].velocity,
+                250.0f,           // flingTimeConstant
+                0.05f,            // flingStopVelocity
+                0.0f,
+                {},
+        };
+        sampleCurve(DEFAULT_CURVE, std::size(DEFAULT_CURVE), config.curve);
+        return config;
+    }();
+
+    // Checks a mapped file before it is published, a rejected file leaves the active config in place.
+    bool validate(const GestureConfig &config, uint64_t fileSize);
+
+    extern std::atomic<const GestureConfig *> active;
+
+    // The config in effect, valid until the end of the current dispatchMotion call.
+    inline const GestureConfig &current() {
+        return *active.load(std::memory_order_acquire);
+    }
+
+    // Maps `path` and publishes it, returns false and keeps the active config if it is missing or invalid.
+    bool load(const char *path);
+
+    // Loads `path` and reloads it from the file watcher whenever it is rewritten or replaced.
+    void watch(const char *path);
+}
@@ -0,0 +1,253 @@
+#include "gesture_engine.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstring>
+#include "logger.h"
+
+#define LOG_TAG "InputInject/CustomGesture"
+
+namespace gesture {
+
+    namespace {
+        inline void emit(Output &out, int32_t action, int32_t actionButton, int32_t buttonState) {
+            if (out.count < Output::MAX_ACTIONS) {
+                out.actions[out.count++] = {action, actionButton, buttonState};
+            }
+        }
+
+        // Reports closer together than this are treated as this far apart, so a batched pair of events with the
+        // same timestamp does not read as an infinite velocity.
+        constexpr float MIN_REPORT_INTERVAL_MS = 1.0f;
+
+    }
+
+    // Interpolated between the two nearest samples of the curve, compiles to min, sqrt and copysign
+    // instructions without branches.
+    float scrollSpeed(float velocity, const config::GestureConfig &config) {
+        constexpr size_t LAST = config::CURVE_SIZE - 1;
+        float x = std::sqrt(std::fmin(std::fabs(velocity) / config.curveMaxVelocity, 1.0f)) * LAST;
+        auto i = std::min(static_cast<size_t>(x), LAST - 1);
+        float f = x - static_cast<float>(i);
+        float speed = config.curve[i] + (config.curve[i + 1] - config.curve[i]) * f;
+        return std::copysign(speed, velocity);
+    }
+
+    void GestureEngine::reset() {
+        bool enabled = state.transformEnabled;
+        memset(&state, 0, sizeof(state));
+        state.lastMode = PointerGestureMode::NEUTRAL;
+        state.transformEnabled = enabled;
+        tracker.clear();
+    }
+
+    constexpr GestureEngine::Transition GestureEngine::transitionOf(size_t last, size_t curr) {
+        using M = PointerGestureMode;
+        auto is = [](size_t index, M mode) { return index == static_cast<size_t>(mode); };
+        bool idle = is(curr, M::NEUTRAL) || is(curr, M::QUIET);
+
+        Handler modeSwitch = nullptr;
+        if (is(curr, M::PRESS)) modeSwitch = &GestureEngine::onSwitchPressDown;
+        else if (is(last, M::PRESS) && idle) modeSwitch = &GestureEngine::onSwitchPressUp;
+
+        Handler action = &GestureEngine::onPassThrough;
+        if (is(curr, M::PRESS)) action = &GestureEngine::onPressDown;
+        else if (is(last, M::PRESS) && idle) action = &GestureEngine::onPressUp;
+        else if (is(curr, M::SWIPE)) action = &GestureEngine::onSwipe;
+        else if (is(curr, M::TAP)) action = &GestureEngine::onTapDown;
+        else if (is(curr, M::NEUTRAL) && (is(last, M::TAP) || is(last, M::TAP_DRAG))) action = &GestureEngine::onTapUp;
+        else if (is(curr, M::BUTTON_CLICK_OR_DRAG) && !is(last, M::BUTTON_CLICK_OR_DRAG))
+            action = &GestureEngine::onClickDown;
+        else if (is(curr, M::HOVER) && is(last, M::BUTTON_CLICK_OR_DRAG)) action = &GestureEngine::onClickUp;
+        return {action, modeSwitch};
+    }
+
+    constexpr std::array<std::array<GestureEngine::Transition, GestureEngine::MODE_COUNT + 1>,
+                         GestureEngine::MODE_COUNT + 1> GestureEngine::transitions = [] {
+        std::array<std::array<Transition, MODE_COUNT + 1>, MODE_COUNT + 1> table{};
+        for (size_t last = 0; last <= MODE_COUNT; ++last) {
+            for (size_t curr = 0; curr <= MODE_COUNT; ++curr) {
+                table[last][curr] = transitionOf(last, curr);
+            }
+        }
+        return table;
+    }();
+
+    void GestureEngine::process(const Input &in, const config::GestureConfig &config, Output &out) {
+        tuning = &config;
+        auto indexOf = [](PointerGestureMode mode) {
+            auto i = static_cast<size_t>(mode);
+            return i < MODE_COUNT ? i : MODE_COUNT;
+        };
+        const Transition &t = transitions[indexOf(state.lastMode)][indexOf(in.mode)];
+
+        out.count = 0;
+        out.scroll = false;
+        out.fling = false;
+        out.stopFling = in.fingerCount > state.lastFingerCount;
+        // with the transform on, the original event is always replaced by mouse events
+        out.cancel = state.transformEnabled;
+        if (state.transformEnabled) {
+            if (state.lastMode == PointerGestureMode::SWIPE && in.mode != PointerGestureMode::SWIPE) {
+                checkFling(in, out);
+            }
+            (this->*t.action)(in, out);
+            state.lastX = in.x;
+            state.lastY = in.y;
+            state.lastWhen = in.when;
+        }
+        if (t.modeSwitch != nullptr) {
+            (this->*t.modeSwitch)(in, out);
+        }
+        state.lastMode = in.mode;
+        state.lastFingerCount = static_cast<uint8_t>(in.fingerCount);
+    }
+
+    // A swipe released while the fingers still move keeps scrolling on its own, see fling.h.
+    void GestureEngine::checkFling(const Input &in, Output &out) {
+        float vx, vy;
+        if (tuning->flingTimeConstant <= 0.0f || in.when - state.lastWhen > VelocityTracker::ASSUME_STOPPED ||
+            !tracker.velocity(&vx, &vy)) {
+            return;
+        }
+        if (std::hypot(vx, vy) < tuning->flingStopVelocity) return;
+        out.fling = true;
+        out.flingVx = -vx;
+        out.flingVy = -vy;
+        out.x = state.swipeX;
+        out.y = state.swipeY;
+    }
+
+    // Every event that is not part of a gesture is passed on as a mouse event with the primary button.
+    void GestureEngine::onPassThrough(const Input &in, Output &out) {
+        emit(out, in.action, AMOTION_EVENT_BUTTON_PRIMARY, AMOTION_EVENT_BUTTON_PRIMARY);
+    }
+
+    // Two fingers pressed and released within the tap timeout is a right click.
+    void GestureEngine::onPressDown(const Input &in, Output &out) {
+        state.pressFingerCount = in.fingerCount;
+        state.pressTime = in.when;
+        LOGD("handlePressGesture: press detected, when=%" PRId64, in.when);
+        onPassThrough(in, out);
+    }
+
+    void GestureEngine::onPressUp(const Input &in, Output &out) {
+        if (state.pressFingerCount == 2) {
+            if (in.when - state.pressTime <= tuning->tapTimeout) {
+                LOGD("handlePressGesture: press release detected, when=%" PRId64, in.when);
+                emit(out, AMOTION_EVENT_ACTION_DOWN, 0, AMOTION_EVENT_BUTTON_SECONDARY);
+                emit(out, AMOTION_EVENT_ACTION_BUTTON_PRESS, AMOTION_EVENT_BUTTON_SECONDARY,
+                     AMOTION_EVENT_BUTTON_SECONDARY);
+                emit(out, AMOTION_EVENT_ACTION_BUTTON_RELEASE, AMOTION_EVENT_BUTTON_SECONDARY, 0);
+                emit(out, AMOTION_EVENT_ACTION_UP, 0, 0);
+                LOGI("handlePressGesture: RIGHT_TAP, when=%" PRId64, in.when);
+            } else {
+                LOGD("handlePressGesture: NOT A TAP, when=%" PRId64, in.when);
+            }
+        }
+        onPassThrough(in, out);
+    }
+
+    // A swipe scrolls, every second event, with the pointer held where the swipe started.
+    void GestureEngine::onSwipe(const Input &in, Output &out) {
+        // avoid huge scroll when gesture triggered first time in this session
+        if (state.lastMode != PointerGestureMode::SWIPE) {
+            state.swipeX = state.lastX;
+            state.swipeY = state.lastY;
+            tracker.clear();
+            tracker.add(in.when, in.x, in.y);
+        } else {
+            float diffX = state.lastX - in.x, diffY = state.lastY - in.y;
+            // scroll by the curve's speed at the fingers' velocity over the time since the last report, so the
+            // distance does not depend on how often the pad reports
+            float dt = std::max(static_cast<float>(in.when - state.lastWhen) * 1e-6f, MIN_REPORT_INTERVAL_MS);
+            // the fit over recent reports smooths out the jitter of single deltas, scrolling runs against the fingers
+            float vx, vy;
+            tracker.add(in.when, in.x, in.y);
+            if (tracker.velocity(&vx, &vy)) {
+                vx = -vx;
+                vy = -vy;
+            } else {
+                vx = diffX / dt;
+                vy = diffY / dt;
+            }
+            state.swipeCount++;
+            state.speedSumX += scrollSpeed(vx, *tuning) * dt;
+            state.speedSumY += scrollSpeed(vy, *tuning) * dt;
+
+            if (state.swipeCount >= 2) {
+                out.scroll = true;
+                out.vscroll = state.speedSumX * tuning->scrollScale;
+                out.hscroll = state.speedSumY * tuning->scrollScale;
+                out.x = state.swipeX;
+                out.y = state.swipeY;
+                emit(out, AMOTION_EVENT_ACTION_HOVER_MOVE, in.actionButton, in.buttonState);
+                emit(out, AMOTION_EVENT_ACTION_SCROLL, in.actionButton, in.buttonState);
+                state.swipeCount = 0;
+                state.speedSumX = 0;
+                state.speedSumY = 0;
+                LOGD("handleSwipeGesture: scroll dx:%0.3f dy:%0.3f a:%0.3f b:%0.3f", diffX, diffY, out.vscroll,
+                     out.hscroll);
+            }
+        }
+        onPassThrough(in, out);
+    }
+
+    // A tap is a left click, released when the tap or the drag that follows it ends.
+    void GestureEngine::onTapDown(const Input &in, Output &out) {
+        LOGD("handleTapGesture: TAP, when=%" PRId64, in.when);
+        emit(out, AMOTION_EVENT_ACTION_DOWN, 0, AMOTION_EVENT_BUTTON_PRIMARY);
+        emit(out, AMOTION_EVENT_ACTION_BUTTON_PRESS, AMOTION_EVENT_BUTTON_PRIMARY, AMOTION_EVENT_BUTTON_PRIMARY);
+        onPassThrough(in, out);
+    }
+
+    void GestureEngine::onTapUp(const Input &in, Output &out) {
+        emit(out, AMOTION_EVENT_ACTION_BUTTON_RELEASE, AMOTION_EVENT_BUTTON_PRIMARY, 0);
+        emit(out, AMOTION_EVENT_ACTION_UP, 0, 0);
+        LOGD("handleTapGesture: TAP OR DRAG RELEASED, when=%" PRId64, in.when);
+        onPassThrough(in, out);
+    }
+
+    // A physical click is a left click.
+    void GestureEngine::onClickDown(const Input &in, Output &out) {
+        LOGD("handleBtnClickDragGesture: CLICK, when=%" PRId64, in.when);
+        emit(out, AMOTION_EVENT_ACTION_DOWN, 0, AMOTION_EVENT_BUTTON_PRIMARY);
+        emit(out, AMOTION_EVENT_ACTION_BUTTON_PRESS, AMOTION_EVENT_BUTTON_PRIMARY, AMOTION_EVENT_BUTTON_PRIMARY);
+    }
+
+    void GestureEngine::onClickUp(const Input &in, Output &out) {
+        emit(out, AMOTION_EVENT_ACTION_BUTTON_RELEASE, AMOTION_EVENT_BUTTON_PRIMARY, 0);
+        emit(out, AMOTION_EVENT_ACTION_UP, 0, 0);
+        LOGD("handleBtnClickDragGesture: CLICK OR DRAG RELEASED, when=%" PRId64, in.when);
+    }
+
+    // Three three-finger taps within the triple tap timeout of each other toggle the transform.
+    void GestureEngine::onSwitchPressDown(const Input &in, Output &) {
+        state.switchFingerCount = in.fingerCount;
+        state.switchPressTime = in.when;
+        LOGD("handleModeSwitch: press detected, when=%" PRId64, in.when);
+    }
+
+    void GestureEngine::onSwitchPressUp(const Input &in, Output &) {
+        if (state.switchFingerCount != 3) return;
+        if (in.when - state.switchPressTime > tuning->tapTimeout) {
+            LOGD("handleModeSwitch: CUSTOM_GESTURE NOT A TAP, when=%" PRId64, in.when);
+            return;
+        }
+        state.tripleTapCount++;
+        LOGD("handleModeSwitch: last_triple_tap_time, when=%" PRId64 " inv=%" PRId64, in.when,
+             in.when - state.lastTripleTapTime);
+        if (in.when - state.lastTripleTapTime <= tuning->tripleTapTimeout) {
+            if (state.tripleTapCount >= 3) {
+                state.transformEnabled = !state.transformEnabled;
+                state.tripleTapCount = 0;
+                LOGI("handleModeSwitch: REQUEST SWITCH CUSTOM GESTURE MODE, ENABLED=%d", state.transformEnabled);
+            }
+        } else {
+            state.tripleTapCount = 1;
+            LOGI("handleModeSwitch: timeout, reset counter, when=%" PRId64, state.lastTripleTapTime);
+        }
+        state.lastTripleTapTime = in.when;
+    }
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <array>
+#include <cstdint>
+#include "gesture_config.h"
+#include "types.h"
+#include "velocity_tracker.h"
+
+// The touchpad gesture transform, independent of the hooks so that it can be built and driven on the host.
+// It sees one dispatchMotion call of the touchpad at a time and answers with the mouse events to dispatch
+// instead, every one of them with the tool type of pointer 0 set to MOUSE.
+namespace gesture {
+
+    struct Input {
+        nsecs_t when;
+        PointerGestureMode mode;  // TouchInputMapper's current pointer gesture mode
+        uint32_t fingerCount;
+        float x, y;               // pointer 0
+        int32_t action;
+        int32_t actionButton;
+        int32_t buttonState;
+    };
+
+    struct Action {
+        int32_t action;
+        int32_t actionButton;
+        int32_t buttonState;
+    };
+
+    struct Output {
+        static constexpr size_t MAX_ACTIONS = 8;
+
+        Action actions[MAX_ACTIONS];
+        size_t count;
+        // drop the original event
+        bool cancel;
+        // set these axes of pointer 0 before dispatching, including the original event if it is not dropped
+        bool scroll;
+        float vscroll, hscroll, x, y;
+        // a swipe ended at (flingVx, flingVy) px/ms, in the direction of the scroll, anchored at x, y
+        bool fling;
+        float flingVx, flingVy;
+        // a finger touched down, any fling must stop
+        bool stopFling;
+    };
+
+    // Everything the engine remembers between events, in one cache line.
+    struct alignas(64) State {
+        nsecs_t pressTime;           // last PRESS seen by the press gesture
+        nsecs_t switchPressTime;     // last PRESS seen by the mode switch
+        nsecs_t lastTripleTapTime;
+        nsecs_t lastWhen;            // of the previous event
+        float lastX, lastY;          // pointer 0 of the previous event
+        float swipeX, swipeY;        // where the pointer is held while scrolling
+        float speedSumX, speedSumY;
+        PointerGestureMode lastMode;
+        uint8_t pressFingerCount;
+        uint8_t switchFingerCount;
+        uint8_t tripleTapCount : 4;  // up to 3
+        uint8_t swipeCount : 3;      // up to 2
+        uint8_t transformEnabled : 1;
+        uint8_t lastFingerCount;
+    };
+
+    static_assert(sizeof(State) == 64);
+
+    // Scroll speed of the curve in `config` at `velocity` (px/ms, signed), in scroll units per ms.
+    float scrollSpeed(float velocity, const config::GestureConfig &config);
+
+    class GestureEngine {
+    public:
+        GestureEngine() {
+            state.transformEnabled = true;
+            reset();
+        }
+
+        // Forgets the gesture in progress, as the reader does on TouchInputMapper::reset.
+        // Whether the transform is enabled survives a reset.
+        void reset();
+
+        // `config` is only used for the duration of the call.
+        void process(const Input &in, const config::GestureConfig &config, Output &out);
+
+        bool transformEnabled() const { return state.transformEnabled; }
+
+        PointerGestureMode lastMode() const { return state.lastMode; }
+
+    private:
+        State state{};
+        const config::GestureConfig *tuning = &config::DEFAULTS; // of the current process() call
+        VelocityTracker tracker;  // of pointer 0 during a swipe
+
+        using Handler = void (GestureEngine::*)(const Input &in, Output &out);
+
+        // What to do on an event, picked by the gesture mode of the previous and of the current event.
+        struct Transition {
+            Handler action;     // when the transform is enabled
+            Handler modeSwitch; // always, may be null
+        };
+
+        static constexpr size_t MODE_COUNT = static_cast<size_t>(PointerGestureMode::QUIET) + 1;
+
+        static constexpr Transition transitionOf(size_t last, size_t curr);
+
+        // indexed by [last][curr], the extra last row and column stand for modes out of range
+        static const std::array<std::array<Transition, MODE_COUNT + 1>, MODE_COUNT + 1> transitions;
+
+        void checkFling(const Input &in, Output &out);
+
+        void onPassThrough(const Input &in, Output &out);
+
+        void onPressDown(const Input &in, Output &out);
+
+        void onPressUp(const Input &in, Output &out);
+
+        void onSwipe(const Input &in, Output &out);
+
+        void onTapDown(const Input &in, Output &out);
+
+        void onTapUp(const Input &in, Output &out);
+
+        void onClickDown(const Input &in, Output &out);
+
+        void onClickUp(const Input &in, Output &out);
+
+        void onSwitchPressDown(const Input &in, Output &out);
+
+        void onSwitchPressUp(const Input &in, Output &out);
+    };
+}
@@ -1,10 +1,29 @@
 #pragma once
 
+#include <atomic>
+#include <cerrno>
+#include <cstring>
 #include <string_view>
+#include <type_traits>
+#include <mutex>
 #include <hook64/And64InlineHook.hpp>
-#include <dlfcn.h>
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include "file_watcher.h"
 #include "logger.h"
 #include "string_utils.h"
+#include "symbol_resolver.h"
+#include "pattern_scanner.h"
+
+#ifndef INPUT_INJECT_BYPASS_PATH
+#if defined(__ANDROID__)
+#define INPUT_INJECT_BYPASS_PATH "/data/system/input_inject.bypass"
+#else
+#define INPUT_INJECT_BYPASS_PATH "/tmp/input_inject.bypass"
+#endif
+#endif
 
 namespace hooks {
 
@@ -13,72 +32,383 @@ namespace hooks {
     constexpr FixedString LIBINPUT_FLIENGER = "libinputflinger.so";
     constexpr FixedString LIBINPUT_FLIENGER_BASE = "libinputflinger_base.so";
 
+    // A hooked "symbol" starting with this prefix is a byte pattern to scan for, see TInstancePatternHook.
+    constexpr const char *SIGNATURE_PREFIX = "sig:";
+    constexpr size_t SIGNATURE_PREFIX_LENGTH = 4;
+
     void setupFunctionHooks(void *moduleBase);
+
+    constexpr size_t MAX_HOOK_SITES = 32;
+    // the in-flight counter of hooks that could not be registered as a site, which nothing waits for
+    constexpr uint32_t UNTRACKED_SITE = MAX_HOOK_SITES;
+
+    // How deep one thread is inside each hook body, including calls to the original through the trampoline.
+    // A thread only ever writes its own counters, so entering and leaving a hook are two plain stores instead
+    // of two atomic read-modify-writes on a shared counter, which cost about as much as the rest of the detour.
+    // Counters are never freed: when their thread exits they are only released, for the next new thread.
+    struct ThreadInFlight {
+        std::atomic<uint8_t> depth[MAX_HOOK_SITES + 1]{};
+        std::atomic<bool> owned{true};
+        ThreadInFlight *next = nullptr;
+    };
+
+    inline std::atomic<ThreadInFlight *> inFlightThreads{nullptr};
+
+    struct ThreadInFlightOwner {
+        ThreadInFlight *counters = nullptr;
+
+        ~ThreadInFlightOwner() {
+            if (counters != nullptr) counters->owned.store(false, std::memory_order_release);
+        }
+    };
+
+    // Takes over the counters of an exited thread, or adds new ones. Once per thread.
+    inline ThreadInFlight *acquireThreadInFlight() {
+        thread_local ThreadInFlightOwner owner;
+        ThreadInFlight *head = inFlightThreads.load(std::memory_order_acquire);
+        for (ThreadInFlight *counters = head; counters != nullptr; counters = counters->next) {
+            bool owned = false;
+            if (counters->owned.compare_exchange_strong(owned, true, std::memory_order_acquire)) {
+                return owner.counters = counters;
+            }
+        }
+        auto counters = new ThreadInFlight;
+        counters->next = head;
+        while (!inFlightThreads.compare_exchange_weak(counters->next, counters, std::memory_order_release)) {}
+        return owner.counters = counters;
+    }
+
+    inline ThreadInFlight &threadInFlight() {
+        thread_local ThreadInFlight *counters = nullptr;
+        if (counters == nullptr) counters = acquireThreadInFlight();
+        return *counters;
+    }
+
+    // Set by setBypass() before it removes the hooks, so threads that took a branch just before then do not
+    // start the hook body.
+    inline std::atomic<bool> bypassed{false};
+
+    // Counts the thread in for a hook body of `site`, unless the hooks are bypassed. Only a compiler barrier
+    // separates the counter from the flag: setBypass() makes every thread pass a full barrier with
+    // heavyBarrier() between setting the flag and reading the counters, so either it sees this thread's
+    // counter or this thread sees the flag.
+    struct InFlightGuard {
+        std::atomic<uint8_t> &depth;
+        bool entered;
+
+        explicit InFlightGuard(uint32_t site) : depth(threadInFlight().depth[site]) {
+            depth.store(depth.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+            entered = !bypassed.load(std::memory_order_relaxed);
+            if (!entered) depth.store(depth.load(std::memory_order_relaxed) - 1, std::memory_order_release);
+        }
+
+        ~InFlightGuard() {
+            if (entered) depth.store(depth.load(std::memory_order_relaxed) - 1, std::memory_order_release);
+        }
+    };
+
+    // Counts the thread out of the hook body of `site` while it calls the original, which runs the same
+    // whether the hooks are bypassed or not, so a hook blocked in its original, like getEvents() waiting
+    // for input, does not hold setBypass() up. Does nothing for a call from outside the hook body.
+    struct OriginalCall {
+        std::atomic<uint8_t> &depth;
+        const bool inside;
+
+        explicit OriginalCall(uint32_t site)
+                : depth(threadInFlight().depth[site]), inside(depth.load(std::memory_order_relaxed) != 0) {
+            if (inside) depth.store(depth.load(std::memory_order_relaxed) - 1, std::memory_order_release);
+        }
+
+        ~OriginalCall() {
+            if (inside) depth.store(depth.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    };
+
+    // Number of threads inside the hook body of `site`.
+    inline uint32_t threadsInside(uint32_t site) {
+        uint32_t inside = 0;
+        for (ThreadInFlight *counters = inFlightThreads.load(std::memory_order_acquire); counters != nullptr;
+             counters = counters->next) {
+            inside += counters->depth[site].load(std::memory_order_acquire) != 0;
+        }
+        return inside;
+    }
+
+    struct HookSite {
+        const char *module;
+        const char *sym;
+        void *address;
+    };
+
+    inline HookSite hookSites[MAX_HOOK_SITES];
+    inline size_t hookSiteCount = 0;
+    inline std::mutex bypassLock;
+
+    // How long setBypass(true) waits for the hook bodies to drain before it gives up and reinstalls the hooks.
+    constexpr uint64_t QUIESCENCE_TIMEOUT_NS = 100 * 1000 * 1000;
+
+    // Makes every thread of the process pass a full memory barrier, see InFlightGuard. Returns false if
+    // the kernel does not support membarrier().
+    inline bool heavyBarrier() {
+        static const bool expedited = syscall(__NR_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0) == 0;
+        return syscall(__NR_membarrier, expedited ? MEMBARRIER_CMD_PRIVATE_EXPEDITED : MEMBARRIER_CMD_SHARED, 0) == 0;
+    }
+
+    // Waits until no thread is inside a hook body, or `QUIESCENCE_TIMEOUT_NS` passed. Only meaningful once
+    // `bypassed` is set and heavyBarrier() returned, when the counters can only drain. Returns whether they did.
+    inline bool waitQuiescent() {
+        const timespec interval{0, 200 * 1000};
+        timespec start{}, now{};
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        while (true) {
+            bool busy = false;
+            for (uint32_t i = 0; i < hookSiteCount && !busy; ++i) {
+                busy = threadsInside(i) != 0;
+            }
+            if (!busy) return true;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            uint64_t waited = static_cast<uint64_t>(now.tv_sec - start.tv_sec) * 1000000000ull + now.tv_nsec
+                              - start.tv_nsec;
+            if (waited >= QUIESCENCE_TIMEOUT_NS) return false;
+            nanosleep(&interval, nullptr);
+        }
+    }
+
+    // Puts the hooks of `count` sites back after a failed bypass.
+    inline void rehookSites(size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            if (!A64RehookFunction(hookSites[i].address)) {
+                logger::info("InputInject/Hooking", "rehook failed %s: %s", hookSites[i].module, hookSites[i].sym);
+            }
+        }
+    }
+
+    // Restores the original code of every registered hook (bypass = true) so events no longer take the detour,
+    // and waits until no thread runs a hook body, or reinstalls the hooks with their old trampolines (false).
+    // Each hook is swapped with one atomic store, so a thread is either before the entry branch or past it,
+    // and trampolines and entry islands are never freed, so one that already took the branch still gets to
+    // the original. A call blocked in an original when the hooks are bypassed, like getEvents() waiting for
+    // input, finishes its hook body when the original returns.
+    // Bypassing fails and leaves the hooks installed if one of them cannot be swapped atomically, see
+    // A64UnhookFunction, or the hook bodies do not drain within `QUIESCENCE_TIMEOUT_NS`. Returns whether the
+    // hooks are in the requested state. Calls are serialized. Must not be called from inside a hook body.
+    inline bool setBypass(bool bypass) {
+        std::lock_guard<std::mutex> lock(bypassLock);
+        if (bypass == bypassed.load(std::memory_order_relaxed)) return true;
+        if (!bypass) {
+            size_t failed = 0;
+            for (size_t i = 0; i < hookSiteCount; ++i) {
+                if (!A64RehookFunction(hookSites[i].address)) {
+                    logger::info("InputInject/Hooking", "rehook failed %s: %s", hookSites[i].module, hookSites[i].sym);
+                    failed++;
+                }
+            }
+            bypassed.store(false, std::memory_order_relaxed);
+            logger::info("InputInject/Hooking", "%zu/%zu hooks reinstalled", hookSiteCount - failed, hookSiteCount);
+            return failed == 0;
+        }
+
+        bypassed.store(true, std::memory_order_relaxed);
+        for (size_t i = 0; i < hookSiteCount; ++i) {
+            HookSite &site = hookSites[i];
+            if (!A64UnhookFunction(site.address)) {
+                logger::info("InputInject/Hooking", "unhook failed %s: %s, hooks stay installed", site.module,
+                             site.sym);
+                rehookSites(i);
+                bypassed.store(false, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        bool drained = heavyBarrier();
+        if (!drained) {
+            logger::info("InputInject/Hooking", "membarrier failed with errno = %d, hooks stay installed", errno);
+        } else if (!(drained = waitQuiescent())) {
+            for (uint32_t i = 0; i < hookSiteCount; ++i) {
+                if (threadsInside(i) != 0) {
+                    logger::info("InputInject/Hooking", "still running %s: %s, hooks stay installed",
+                                 hookSites[i].module, hookSites[i].sym);
+                }
+            }
+        }
+        if (!drained) {
+            rehookSites(hookSiteCount);
+            bypassed.store(false, std::memory_order_relaxed);
+            return false;
+        }
+        logger::info("InputInject/Hooking", "%zu hooks bypassed", hookSiteCount);
+        return true;
+    }
+
+    // Applies the bypass control file at `path`: "1" bypasses the hooks, anything else reinstalls them.
+    inline void applyBypassControl(const char *path) {
+        bool bypass = false;
+        if (FILE *file = fopen(path, "re")) {
+            bypass = fgetc(file) == '1';
+            fclose(file);
+        }
+        setBypass(bypass);
+    }
+
+    // Applies the bypass control file at `path` now and again whenever it changes. Call after the hooks
+    // have been committed.
+    inline void watchBypass(const char *path) {
+        applyBypassControl(path);
+        if (!watcher::add(path, applyBypassControl)) {
+            logger::error("InputInject/Hooking", "cannot watch %s, bypass cannot be switched", path);
+        }
+    }
+
+    template<typename T, typename Fn>
+    struct HookEntry;
+
+    // The function actually installed for a THook: runs T::_hook under the in-flight counter of T's site.
+    template<typename T, typename R, typename... Args>
+    struct HookEntry<T, R (T::*)(Args...)> {
+        static constexpr auto value = &T::template _entry<Args...>;
+    };
 }
 
 
 #define VA_EXPAND(...) __VA_ARGS__
 
+// One entry per SymCall target. Entries are emitted into their own section by every instantiation of
+// SymCallSlot, so the whole table is known at link time and hooks::resolveSymCalls() can fill it in one
+// pass at load time, before any hook is live. Calls then only load the resolved address.
+// Relies on clang keeping the section of template static members; GCC silently drops it, which the
+// static_assert in SymCallSlot catches, and entry.cpp fails to link if the section is missing.
+struct SymCallEntry {
+    const char *module;
+    const char *sym;
+    uint32_t hash;
+    void *address;
+};
+
+#define SYMCALL_SECTION "symcall_table"
+
+#if defined(__clang__)
+#define SYMCALL_SECTION_KEPT true
+#else
+#define SYMCALL_SECTION_KEPT false
+#endif
+
+template<FixedString Mod, FixedString Fn>
+struct SymCallSlot {
+    // dependent, so that only a SymCall actually used by a GCC build fails
+    static_assert(SYMCALL_SECTION_KEPT || sizeof(Fn) == 0, "SymCall needs clang, GCC drops the section of the table");
+    static inline SymCallEntry entry __attribute__((used, section(SYMCALL_SECTION))) = {
+            Mod.c_str(), Fn.c_str(), resolver::gnuHash(Fn), nullptr};
+};
+
+namespace hooks {
+    // Resolves every SymCall target of the library, called once from a constructor in entry.cpp.
+    // Returns the number of targets that could not be found. The hooks are not installed if there are any.
+    size_t resolveSymCalls();
+}
+
+// Stands in for a SymCall target that was not found, so a call does nothing instead of jumping to null.
+template<typename ret, typename... p>
+static ret __imp_Missing(p...) {
+    if constexpr (!std::is_void_v<ret>) return ret{};
+}
+
 template<FixedString Mod, FixedString Fn, typename ret, typename... p>
-static auto __imp_Call() {
-    static void *funcCache = nullptr;
-    if (funcCache == nullptr) {
-        logger::info("InputInject/Hooking", "creating dlsym cache");
-        auto handle = dlopen(Mod, RTLD_NOW);
-        if (handle == nullptr) {
-            logger::info("InputInject/Hooking", "dlsym_cache handle not found %s", Mod.c_str());
-        }
-        funcCache = dlsym(handle, Fn);
-        if (funcCache == nullptr) {
-            logger::info("InputInject/Hooking", "dlsym_cache func not found %s: %s", Mod.c_str(), Fn.c_str());
-        }
-        logger::info("InputInject/Hooking", "dlsym_cache cached %s: %s at %p", Mod.c_str(), Fn.c_str(), funcCache);
-    }
-    return ((ret(*)(p...)) (funcCache));
+static inline auto __imp_Call() {
+    void *address = SymCallSlot<Mod, Fn>::entry.address;
+    return address != nullptr ? (ret(*)(p...)) address : &__imp_Missing<ret, p...>;
 }
 
 #define SymCall(mod, fn, ret, ...) (__imp_Call<mod, fn, ret, __VA_ARGS__>())
 
 class THookRegister {
 public:
-    THookRegister(void *address, void *hook, void **org) {
+    THookRegister(void *address, void *hook, void **org, uint32_t *site = nullptr) {
         A64HookFunction(reinterpret_cast<void *const>(address), reinterpret_cast<void *const>(hook),
                         reinterpret_cast<void **>(org));
+        addSite("", "", address, site);
     }
 
-    THookRegister(const char *module, const char *sym, void *hook, void **org) {
-        auto handle = dlopen(module, RTLD_NOW);
-        auto func = dlsym(handle, sym);
+    THookRegister(const char *module, const char *sym, void *hook, void **org,
+                  uint32_t *site = nullptr)
+            : THookRegister(module, sym, resolver::gnuHash(sym), hook, org, site) {}
+
+    THookRegister(const char *module, const char *sym, uint32_t symHash, void *hook, void **org,
+                  uint32_t *site = nullptr) {
+        auto func = strncmp(sym, hooks::SIGNATURE_PREFIX, hooks::SIGNATURE_PREFIX_LENGTH) == 0
+                    ? scanner::findUnique(module, sym + hooks::SIGNATURE_PREFIX_LENGTH)
+                    : resolver::findSymbol(module, sym, symHash);
         if (func == nullptr) {
             logger::info("InputInject/Hooking", "func not found %s: %s", module, sym);
         } else {
             A64HookFunction(reinterpret_cast<void *const>(func), reinterpret_cast<void *const>(hook),
                             reinterpret_cast<void **>(org));
-            logger::info("InputInject/Hooking", "Hooked %s: %s", module, sym);
+            if (*org == nullptr) {
+                logger::info("InputInject/Hooking", "hook failed %s: %s", module, sym);
+                return;
+            }
+            uintptr_t mapped, used;
+            A64GetTrampolineUsage(&mapped, &used);
+            logger::info("InputInject/Hooking", "Hooked %s: %s (trampolines %zu/%zu bytes)", module, sym,
+                         (size_t) used, (size_t) mapped);
+            addSite(module, sym, func, site);
         }
     }
 
     template<typename T>
-    THookRegister(const char *module, const char *sym, T hook, void **org) {
+    THookRegister(const char *module, const char *sym, T hook, void **org, uint32_t *site = nullptr) {
+        union {
+            T a;
+            void *b;
+        } hookUnion;
+        hookUnion.a = hook;
+        THookRegister(module, sym, hookUnion.b, org, site);
+    }
+
+    template<typename T>
+    THookRegister(const char *module, const char *sym, uint32_t symHash, T hook, void **org,
+                  uint32_t *site = nullptr) {
         union {
             T a;
             void *b;
         } hookUnion;
         hookUnion.a = hook;
-        THookRegister(module, sym, hookUnion.b, org);
+        THookRegister(module, sym, symHash, hookUnion.b, org, site);
     }
 
     template<typename T>
-    THookRegister(void *address, T hook, void **org) {
+    THookRegister(void *address, T hook, void **org, uint32_t *site = nullptr) {
         union {
             T a;
             void *b;
         } hookUnion;
         hookUnion.a = hook;
-        THookRegister(address, hookUnion.b, org);
+        THookRegister(address, hookUnion.b, org, site);
+    }
+
+private:
+    // Registers the hook for setBypass() and stores its index, which its in-flight counters are kept under, in `site`.
+    static void addSite(const char *module, const char *sym, void *address, uint32_t *site) {
+        if (hooks::hookSiteCount == hooks::MAX_HOOK_SITES) {
+            logger::info("InputInject/Hooking", "too many hooks, %s: %s cannot be bypassed", module, sym);
+            return;
+        }
+        if (site != nullptr) *site = static_cast<uint32_t>(hooks::hookSiteCount);
+        hooks::hookSites[hooks::hookSiteCount++] = {module, sym, address};
     }
 };
 
+// Hook registrations run after the constructor that opens the install batch (priority 101) and
+// before lib_entry(), which commits it, so all patches are applied together.
+#define THOOK_INIT_PRIORITY __attribute__((init_priority(200)))
+
+// Keeps each registration local to its file. GCC rejects a storage class on an explicit specialization,
+// host builds with it give the registrations external linkage instead, which is fine while hook names are unique.
+#if defined(__clang__)
+#define THOOK_REGISTER_STORAGE static
+#else
+#define THOOK_REGISTER_STORAGE
+#endif
+
 #define VA_EXPAND(...) __VA_ARGS__
 template<uint64_t, uint64_t>
 struct THookTemplate;
@@ -95,14 +425,28 @@ extern THookRegister THookRegisterTemplate;
         }                                                                                    \
         template <typename... Params>                                                        \
         static ret original(pclass* _this, Params&&... params) {                             \
+            hooks::OriginalCall call(_site());                                               \
             return (((THookTemplate*)_this)->*_original())(std::forward<Params>(params)...); \
         }                                                                                    \
+        static uint32_t& _site() {                                                           \
+            static uint32_t index = hooks::UNTRACKED_SITE;                                   \
+            return index;                                                                    \
+        }                                                                                    \
+        template <typename... Args>                                                          \
+        ret _entry(Args... args) {                                                           \
+            hooks::InFlightGuard guard(_site());                                             \
+            if (!guard.entered) return (this->*_original())(std::forward<Args>(args)...);    \
+            return _hook(std::forward<Args>(args)...);                                       \
+        }                                                                                    \
         ret _hook(__VA_ARGS__);                                                              \
     };                                                                                       \
     template <>                                                                              \
-    static THookRegister THookRegisterTemplate<do_hash(iname), do_hash(mod)>{                \
-        mod,sym, &THookTemplate<do_hash(iname), do_hash(mod)>::_hook,                        \
-        (void**)&THookTemplate<do_hash(iname), do_hash(mod)>::_original()};                  \
+    THOOK_REGISTER_STORAGE THookRegister THookRegisterTemplate<do_hash(iname), do_hash(mod)> THOOK_INIT_PRIORITY{ \
+        mod, sym, std::integral_constant<uint32_t, resolver::gnuHash(sym)>::value,           \
+        hooks::HookEntry<THookTemplate<do_hash(iname), do_hash(mod)>,                        \
+                         THookTemplate<do_hash(iname), do_hash(mod)>::original_type>::value, \
+        (void**)&THookTemplate<do_hash(iname), do_hash(mod)>::_original(),                   \
+        &THookTemplate<do_hash(iname), do_hash(mod)>::_site()};                              \
     ret THookTemplate<do_hash(iname), do_hash(mod)>::_hook(__VA_ARGS__)
 
 #define _TInstanceDefHook(iname, mod, sym, ret, type, ...) \
@@ -120,3 +464,7 @@ extern THookRegister THookRegisterTemplate;
     _TInstanceDefHook(iname, mod, sym, ret, type, VA_EXPAND(__VA_ARGS__))
 #define TInstanceHook(ret, mod, sym, type, ...) \
     TInstanceHook2(sym, ret, mod, sym, type, VA_EXPAND(__VA_ARGS__))
+// Hooks the function found by a byte pattern such as "FD 7B ?? A9", for ROMs that do not export it.
+// The pattern must match exactly once in the executable segments of `mod`.
+#define TInstancePatternHook(ret, mod, pattern, type, ...) \
+    TInstanceHook2(pattern, ret, mod, "sig:" pattern, type, VA_EXPAND(__VA_ARGS__))
@@ -1,20 +1,21 @@
 #include "hookapi.h"
 #include "types.h"
 
+#include <cinttypes>
 #include <cstdint>
 #include <string>
 #include <array>
+#include "device_rules.h"
+#include "device_table.h"
+#include "enum_names.h"
+#include "fling.h"
+#include "gesture_config.h"
+#include "gesture_engine.h"
 #include "logger.h"
-#include "magic_enum.hpp"
-
-template<typename Function>
-struct Defer {
-    Function f;
-
-    explicit Defer(Function f) : f(f) {}
-
-    ~Defer() { f(); }
-};
+#include "motion_recorder.h"
+#include "vtable_hook.h"
+#include "symbol_cache.h"
+#include "symbol_resolver.h"
 
 namespace android {
     struct InputDeviceIdentifier {
@@ -42,6 +43,19 @@ namespace android {
         InputDeviceIdentifier mIdentifier;
 
     };
+    // only hooked, never looked into
+    struct EventHub {
+    };
+
+    struct RawEvent {
+        nsecs_t when;
+        nsecs_t readTime;
+        int32_t deviceId; // the EventHub id of the device, InputDeviceContext::mId
+        int32_t type;
+        int32_t code;
+        int32_t value;
+    };
+
     struct InputDeviceContext {
         InputDevice *mDevice;
 
@@ -57,16 +71,21 @@ namespace android {
         uint64_t _vptr;
         InputDeviceContext *mDeviceContext;
 
+        // reverse-engineered from one build of libinputreader.so, see checkTouchMapperLayout()
+        static constexpr uint64_t CURRENT_GESTURE_MODE_OFFSET = 2086 * 4;
+        static constexpr uint64_t CURRENT_FINGER_ID_BITS_OFFSET = 1054 * 4;
+        static constexpr uint64_t SWIPE_MAX_WIDTH_RATIO_OFFSET = 0x118;
+
         inline PointerGestureMode &getCurrentGestureMode() {
-            return *(PointerGestureMode *) ((char *) this + 2086 * 4);
+            return *(PointerGestureMode *) ((char *) this + CURRENT_GESTURE_MODE_OFFSET);
         }
 
         inline BitSet32 &getCurrentFingerIdBits() {
-            return *(BitSet32 *) ((char *) this + 1054 * 4);
+            return *(BitSet32 *) ((char *) this + CURRENT_FINGER_ID_BITS_OFFSET);
         }
 
         inline float &getPointerGestureSwipeMaxWidthRatio() {
-            return *(float *) ((char *) this + 0x118);
+            return *(float *) ((char *) this + SWIPE_MAX_WIDTH_RATIO_OFFSET);
         }
     };
 
@@ -76,362 +95,332 @@ namespace android {
 }
 #define LOG_TAG "InputInject/CustomGesture"
 
-constexpr const char *XIAOMI_TOUCH_DEVICE_NAME = "Xiaomi Touch";
+#define DISPATCH_MOTION_SYM \
+    "_ZN7android16TouchInputMapper14dispatchMotionElljjiiiiiiPKNS_17PointerPropertiesEPKNS_13PointerCoordsEPKjNS_8BitSet32Eiffl"
+
+// The mappers of matched touchpads run on a private copy of their vtable, which both tags them for
+// dispatchMotion and redirects their virtual functions without touching any other device.
+static VTableHook touchpadVTable;
+
+constexpr size_t MAX_TOUCH_DEVICES = 16;
+
+struct Touchpad {
+    gesture::GestureEngine gestures;
+    const devices::Rule *rule;
+    android::TouchInputMapper *mapper;
+};
+
+// Every attached mapper by device id, only touched on the InputReader thread.
+// Entries are added by configureInputDevice and removed when the mapper is deleted.
+static DeviceTable<Touchpad, MAX_TOUCH_DEVICES> touchpads;
+
+// Type of the synthetic event that brings the queued fling steps to the mapper, see touchProcess. Below
+// EventHubInterface::FIRST_SYNTHETIC_EVENT, so the reader routes it to the device like a kernel event,
+// and far above EV_MAX, so no kernel event has it.
+constexpr int32_t FLING_EVENT_TYPE = 0x0f11f000;
+
+// What the reader needs to dispatch the steps of the running fling, copied from the event that ended the
+// swipe. Reader thread only.
+static struct {
+    int32_t deviceId = -1;
+    int32_t eventHubId = -1;
+    android::EventHubInterface *eventHub;
+    uint32_t policyFlags, source;
+    int32_t flags, metaState, edgeFlags, changedId;
+    float xPrecision, yPrecision, x, y;
+    ::android::BitSet32 idBits;
+    MotionClassification classification;
+    PropertiesArray properties;
+    CoordsArray coords;
+    IdToIndexArray idToIndex;
+} flingSource;
+
+static void (*touchResetOriginal)(android::TouchInputMapper *, nsecs_t) = nullptr;
+static void (*touchProcessOriginal)(android::TouchInputMapper *, const android::RawEvent *) = nullptr;
+static void (*touchDeleteOriginal)(android::TouchInputMapper *) = nullptr;
+
+// Called from the fling thread: EventHub::wake only writes to the hub's wake pipe, which is thread-safe.
+static void wakeEventHub(void *eventHub) {
+    SymCall(hooks::LIBINPUT_READER, "_ZN7android8EventHub4wakeEv", void, void *)(eventHub);
+}
+
+// The gesture state of an attached mapper, or nullptr if the table had no room for its device.
+// A device the reader has regenerated since the last event starts over with a fresh gesture.
+static gesture::GestureEngine *gesturesOf(android::TouchInputMapper *mapper) {
+    auto entry = touchpads.find(mapper->mDeviceContext->mDeviceId);
+    if (entry == nullptr) return nullptr;
+    int32_t generation = mapper->mDeviceContext->mDevice->mGeneration;
+    if (entry->generation != generation) {
+        entry->generation = generation;
+        entry->value.gestures.reset();
+    }
+    return &entry->value.gestures;
+}
+
+// TouchInputMapper::reset, only for attached mappers: the reader drops the current gesture, so must we.
+static void touchReset(android::TouchInputMapper *mapper, nsecs_t when) {
+    LOGD("reset(deviceId=%d when=%" PRId64 ")", mapper->mDeviceContext->mDeviceId, when);
+    if (auto gestures = gesturesOf(mapper)) gestures->reset();
+    touchResetOriginal(mapper, when);
+}
+
+// The deleting destructor of attached mappers, called when the device is removed. The device context
+// outlives its mappers, so the device id can still be read here.
+static void touchDelete(android::TouchInputMapper *mapper) {
+    LOGI("removed(deviceId=%d)", mapper->mDeviceContext->mDeviceId);
+    if (flingSource.deviceId == mapper->mDeviceContext->mDeviceId) fling::cancel();
+    touchpads.erase(mapper->mDeviceContext->mDeviceId);
+    touchDeleteOriginal(mapper);
+}
+
+// Checks that the hardcoded TouchInputMapper offsets hold plausible values in this build of libinputreader.so.
+// A build that passed once is remembered in the symbol cache under its build-id and not checked again.
+static bool checkTouchMapperLayout(android::TouchInputMapper *mapper) {
+    using android::TouchInputMapper;
+    constexpr const char *LAYOUT_KEY = "TouchInputMapper.layout";
+    constexpr uint64_t layout = TouchInputMapper::CURRENT_GESTURE_MODE_OFFSET |
+                                TouchInputMapper::CURRENT_FINGER_ID_BITS_OFFSET << 21 |
+                                TouchInputMapper::SWIPE_MAX_WIDTH_RATIO_OFFSET << 42;
+
+    uint64_t buildKey = resolver::buildKey(hooks::LIBINPUT_READER);
+    uint64_t cached;
+    if (symcache::get(buildKey, LAYOUT_KEY, &cached) && cached == layout) {
+        return true;
+    }
+
+    auto mode = mapper->getCurrentGestureMode();
+    auto fingers = mapper->getCurrentFingerIdBits().count();
+    float ratio = mapper->getPointerGestureSwipeMaxWidthRatio();
+    if (mode > PointerGestureMode::QUIET || fingers > MAX_POINTERS || !(ratio > 0.0f && ratio <= 1.0f)) {
+        LOGE("checkTouchMapperLayout: unexpected layout, gestureMode=%u fingers=%u swipeRatio=%f",
+             (uint32_t) mode, fingers, ratio);
+        return false;
+    }
+    symcache::put(buildKey, LAYOUT_KEY, layout);
+    LOGI("checkTouchMapperLayout: layout validated for this build");
+    return true;
+}
+
+static void touchProcess(android::TouchInputMapper *mapper, const android::RawEvent *rawEvent);
+
+static bool attachTouchpad(android::TouchInputMapper *mapper) {
+    static int resetSlot = VTableHook::slotOf(hooks::LIBINPUT_READER, "_ZTVN7android16TouchInputMapperE",
+                                              "_ZN7android16TouchInputMapper5resetEl");
+    static int deleteSlot = VTableHook::slotOf(hooks::LIBINPUT_READER, "_ZTVN7android16TouchInputMapperE",
+                                               "_ZN7android16TouchInputMapperD0Ev");
+    static int processSlot = VTableHook::slotOf(hooks::LIBINPUT_READER, "_ZTVN7android16TouchInputMapperE",
+                                                "_ZN7android16TouchInputMapper7processEPKNS_8RawEventE");
+    if (processSlot < 0) return false;
+    touchpadVTable.redirect(resetSlot, (void *) &touchReset, (void **) &touchResetOriginal);
+    touchpadVTable.redirect(processSlot, (void *) &touchProcess, (void **) &touchProcessOriginal);
+    touchpadVTable.redirect(deleteSlot, (void *) &touchDelete, (void **) &touchDeleteOriginal);
+    return touchpadVTable.attach(mapper);
+}
 
 TInstanceHook(void, hooks::LIBINPUT_READER,
               "_ZN7android16TouchInputMapper20configureInputDeviceElPb",
               android::TouchInputMapper, nsecs_t when, bool *outResetNeeded) {
 
-    if (this->mDeviceContext->mDevice->mIdentifier.name == XIAOMI_TOUCH_DEVICE_NAME) {
-        LOGI("configureInputDevice(deviceId=%d deviceName=%s)",
-             this->mDeviceContext->mDeviceId,
-             this->mDeviceContext->mDevice->mIdentifier.name.c_str());
-        getPointerGestureSwipeMaxWidthRatio() = 0.5f;
+    const devices::Rule *rule;
+    if (touchpadVTable.owns(this)) {
+        auto entry = touchpads.find(this->mDeviceContext->mDeviceId);
+        rule = entry != nullptr ? entry->value.rule : nullptr;
+    } else {
+        const android::InputDeviceIdentifier &identifier = this->mDeviceContext->mDevice->mIdentifier;
+        rule = devices::match({identifier.name.c_str(), identifier.location.c_str(), identifier.bus,
+                               identifier.vendor, identifier.product});
+        if (rule == nullptr) {
+            return original(this, when, outResetNeeded);
+        }
+        LOGI("configureInputDevice(deviceId=%d deviceName=%s location=%s bus=%04x vendor=%04x product=%04x)",
+             this->mDeviceContext->mDeviceId, identifier.name.c_str(), identifier.location.c_str(),
+             identifier.bus, identifier.vendor, identifier.product);
+        if (!checkTouchMapperLayout(this)) {
+            return original(this, when, outResetNeeded);
+        }
+        if (!attachTouchpad(this)) {
+            LOGE("configureInputDevice: cannot attach to deviceId=%d, gestures stay stock",
+                 this->mDeviceContext->mDeviceId);
+            return original(this, when, outResetNeeded);
+        }
     }
-    return original(this, when, outResetNeeded);
+    if (rule != nullptr) {
+        getPointerGestureSwipeMaxWidthRatio() = rule->swipeMaxWidthRatio != 0.0f
+                                                ? rule->swipeMaxWidthRatio
+                                                : config::current().swipeMaxWidthRatio;
+    }
+    // the reader may regenerate the device while configuring it, so take the generation afterwards
+    original(this, when, outResetNeeded);
+    auto entry = touchpads.insert(this->mDeviceContext->mDeviceId, this->mDeviceContext->mDevice->mGeneration);
+    if (entry == nullptr) {
+        LOGE("configureInputDevice: more than %zu touch devices, deviceId=%d stays stock",
+             MAX_TOUCH_DEVICES, this->mDeviceContext->mDeviceId);
+        return;
+    }
+    entry->value.rule = rule;
+    entry->value.mapper = this;
 }
 
-TInstanceHook(void, hooks::LIBINPUT_READER,
-              "_ZN7android16TouchInputMapper14dispatchMotionElljjiiiiiiPKNS_17PointerPropertiesEPKNS_13PointerCoordsEPKjNS_8BitSet32Eiffl",
-              android::TouchInputMapper,
+// Copies what dispatchMotion was called with into the recorder's ring, the pointers in id order.
+static void recordMotion(int32_t deviceId, const gesture::Input &in, nsecs_t readTime, const CoordsArray &coords,
+                         const IdToIndexArray &idToIndex, ::android::BitSet32 idBits) {
+    recorder::Event event;
+    event.when = in.when;
+    event.readTime = readTime;
+    event.deviceId = deviceId;
+    event.action = in.action;
+    event.idBits = idBits.value;
+    event.mode = in.mode;
+    event.fingerCount = in.fingerCount;
+    event.pointerCount = 0;
+    for (::android::BitSet32 bits = idBits; !bits.isEmpty() && event.pointerCount < MAX_POINTERS;) {
+        const PointerCoords &pointer = coords[idToIndex[bits.clearFirstMarkedBit()]];
+        event.x[event.pointerCount] = pointer.getAxisValue(AMOTION_EVENT_AXIS_X);
+        event.y[event.pointerCount] = pointer.getAxisValue(AMOTION_EVENT_AXIS_Y);
+        event.pointerCount++;
+    }
+    recorder::record(event);
+}
+
+TInstanceHook(void, hooks::LIBINPUT_READER, DISPATCH_MOTION_SYM, android::TouchInputMapper,
               nsecs_t when, nsecs_t readTime, uint32_t policyFlags, uint32_t source, int32_t action,
               int32_t actionButton, int32_t flags, int32_t metaState, int32_t buttonState,
               int32_t edgeFlags, PropertiesArray *properties, CoordsArray *coords,
               IdToIndexArray *idToIndex, ::android::BitSet32 idBits, int32_t changedId, float xPrecision,
               float yPrecision, nsecs_t downTime, MotionClassification classification) {
-#pragma clang diagnostic push
-#pragma ide diagnostic ignored "readability-static-accessed-through-instance"
+    gesture::GestureEngine *gestures = touchpadVTable.owns(this) ? gesturesOf(this) : nullptr;
+    if (gestures == nullptr) {
+        return original(this, when, readTime, policyFlags, source, action, actionButton, flags, metaState,
+                        buttonState, edgeFlags, properties, coords, idToIndex, idBits, changedId, xPrecision,
+                        yPrecision, downTime, classification);
+    }
 
-    static void *xiaomiTouchDevice = nullptr;
-    static bool enableGestureTransform = true;
-    if (xiaomiTouchDevice == nullptr && this->mDeviceContext->mDevice->mIdentifier.name == XIAOMI_TOUCH_DEVICE_NAME) {
-        xiaomiTouchDevice = this->mDeviceContext->mDevice;
+    gesture::Input in{when, getCurrentGestureMode(), getCurrentFingerIdBits().count(),
+                      coords->at(0).getAxisValue(AMOTION_EVENT_AXIS_X),
+                      coords->at(0).getAxisValue(AMOTION_EVENT_AXIS_Y),
+                      action, actionButton, buttonState};
+
+    if (recorder::recording()) {
+        recordMotion(this->mDeviceContext->mDeviceId, in, readTime, *coords, *idToIndex, idBits);
     }
 
-    if (this->mDeviceContext->mDevice == xiaomiTouchDevice) {
-
-        // ==================== Collect Info ====================
-        static PointerGestureMode last_gesture = PointerGestureMode::NEUTRAL;
-
-        auto curr_gesture = getCurrentGestureMode();
-        auto finger_count = getCurrentFingerIdBits().count();
-
-        LOGD("dispatchMotion(deviceId=%d deviceName=%s gestureMode=%s, last_gesture=%s count=%d)",
-             this->mDeviceContext->mDeviceId,
-             this->mDeviceContext->mDevice->mIdentifier.name.c_str(),
-             std::string(magic_enum::enum_name(getCurrentGestureMode())).c_str(),
-             std::string(magic_enum::enum_name(last_gesture)).c_str(),
-             finger_count
-        );
-
-        auto hookInstance = this;
-
-        auto handleModeSwitch = [=]() {
-            // last_finger_count is set when press detected, used to identify press release gesture
-            static uint32_t last_finger_count = 0;
-            // last_press_time is used to detect press release time interval
-            // only update when press detected
-            static nsecs_t last_press_time = 0;
-
-            // press gestures are activated when two or more fingers are placed on the touchpad
-            if (curr_gesture == PointerGestureMode::PRESS) {
-                last_finger_count = finger_count;
-                last_press_time = when;
-                LOGD("handleModeSwitch: press detected, when=%lld", when);
-            }
-
-            // press release gesture triggered when all fingers are released and last gesture is press
-            if ((curr_gesture == PointerGestureMode::NEUTRAL || curr_gesture == PointerGestureMode::QUIET) &&
-                last_gesture == PointerGestureMode::PRESS && last_finger_count == 3) {
-                if ((when - last_press_time) <= 150 * 1000000LL) {         // 150 ms
-                    static size_t tripleTapCounter = 0;
-                    tripleTapCounter++;
-                    // reset counter if last triple tap is too long ago
-                    static nsecs_t last_triple_tap_time = 0;
-
-                    LOGD("handleModeSwitch: last_triple_tap_time, when=%lld inv=%lld", when,
-                         (when - last_triple_tap_time));
-                    if ((when - last_triple_tap_time) <= 1500 * 1000000LL) {
-                        if (tripleTapCounter >= 3) {
-                            enableGestureTransform = !enableGestureTransform;
-                            tripleTapCounter = 0;
-                            LOGI("handleModeSwitch: REQUEST SWITCH CUSTOM GESTURE MODE, ENABLED=%d",
-                                 enableGestureTransform);
-                        }
-                    } else {
-                        tripleTapCounter = 1;
-                        LOGI("handleModeSwitch: timeout, reset counter, when=%lld",
-                             last_triple_tap_time);
-                    }
-
-                    last_triple_tap_time = when;
-
-
-                } else {
-                    LOGD("handleModeSwitch: CUSTOM_GESTURE NOT A TAP, when=%lld", when);
-                }
-
-            }
-        };
-
-        auto handleTapGesture = [&]() -> bool {
-            if (curr_gesture == PointerGestureMode::TAP) {
-                LOGD("handleTapGesture: TAP, when=%lld", when);
-                auto new_properties = *properties;
-                new_properties.at(0).toolType = ToolType::MOUSE;
-                hookInstance->original(hookInstance, when, readTime, policyFlags, source,
-                                       AMOTION_EVENT_ACTION_DOWN, 0, flags, metaState,
-                                       AMOTION_EVENT_BUTTON_PRIMARY,
-                                       edgeFlags, &new_properties, coords, idToIndex, idBits, changedId,
-                                       xPrecision, yPrecision, downTime, classification);
-                hookInstance->original(hookInstance, when, readTime, policyFlags, source,
-                                       AMOTION_EVENT_ACTION_BUTTON_PRESS, AMOTION_EVENT_BUTTON_PRIMARY, flags,
-                                       metaState,
-                                       AMOTION_EVENT_BUTTON_PRIMARY,
-                                       edgeFlags, &new_properties, coords, idToIndex, idBits, changedId,
-                                       xPrecision, yPrecision, downTime, classification);
-                return false;
-            }
-
-            if (curr_gesture == PointerGestureMode::NEUTRAL &&
-                (last_gesture == PointerGestureMode::TAP_DRAG || last_gesture == PointerGestureMode::TAP)) {
-                auto new_properties = *properties;
-                new_properties.at(0).toolType = ToolType::MOUSE;
-                hookInstance->original(hookInstance, when, readTime, policyFlags, source,
-                                       AMOTION_EVENT_ACTION_BUTTON_RELEASE, AMOTION_EVENT_BUTTON_PRIMARY, flags,
-                                       metaState,
-                                       0,
-                                       edgeFlags, &new_properties, coords, idToIndex, idBits, changedId,
-                                       xPrecision, yPrecision, downTime, classification);
-                hookInstance->original(hookInstance, when, readTime, policyFlags, source,
-                                       AMOTION_EVENT_ACTION_UP, 0, flags, metaState, 0,
-                                       edgeFlags, &new_properties, coords, idToIndex, idBits, changedId,
-                                       xPrecision, yPrecision, downTime, classification);
-                LOGD("handleTapGesture: TAP OR DRAG RELEASED, when=%lld", when);
-                return true;
-            }
-            return false;
-        };
-
-        auto handleBtnClickDragGesture = [&]() -> bool {
-            auto new_properties = *properties;
-            new_properties.at(0).toolType = ToolType::MOUSE;
-            if (curr_gesture == PointerGestureMode::BUTTON_CLICK_OR_DRAG &&
-                last_gesture != PointerGestureMode::BUTTON_CLICK_OR_DRAG) {
-                LOGD("handleTapGesture: TAP, when=%lld", when);
-                hookInstance->original(hookInstance, when, readTime, policyFlags, source,
-                                       AMOTION_EVENT_ACTION_DOWN, 0, flags, metaState,
-                                       AMOTION_EVENT_BUTTON_PRIMARY,
-                                       edgeFlags, &new_properties, coords, idToIndex, idBits, changedId,
-                                       xPrecision, yPrecision, downTime, classification);
-                hookInstance->original(hookInstance, when, readTime, policyFlags, source,
-                                       AMOTION_EVENT_ACTION_BUTTON_PRESS, AMOTION_EVENT_BUTTON_PRIMARY, flags,
-                                       metaState,
-                                       AMOTION_EVENT_BUTTON_PRIMARY,
-                                       edgeFlags, &new_properties, coords, idToIndex, idBits, changedId,
-                                       xPrecision, yPrecision, downTime, classification);
-                return true;
-            }
-
-            if (curr_gesture == PointerGestureMode::HOVER && last_gesture == PointerGestureMode::BUTTON_CLICK_OR_DRAG) {
-
-                hookInstance->original(hookInstance, when, readTime, policyFlags, source,
-                                       AMOTION_EVENT_ACTION_BUTTON_RELEASE, AMOTION_EVENT_BUTTON_PRIMARY, flags,
-                                       metaState,
-                                       0,
-                                       edgeFlags, &new_properties, coords, idToIndex, idBits, changedId,
-                                       xPrecision, yPrecision, downTime, classification);
-                hookInstance->original(hookInstance, when, readTime, policyFlags, source,
-                                       AMOTION_EVENT_ACTION_UP, 0, flags, metaState, 0,
-                                       edgeFlags, &new_properties, coords, idToIndex, idBits, changedId,
-                                       xPrecision, yPrecision, downTime, classification);
-
-                LOGD("handleTapGesture: TAP OR DRAG RELEASED, when=%lld", when);
-                return true;
-            }
-            hookInstance->original(hookInstance, when, readTime, policyFlags, source,
-                                   action, AMOTION_EVENT_BUTTON_PRIMARY, flags, metaState, AMOTION_EVENT_BUTTON_PRIMARY,
-                                   edgeFlags, &new_properties, coords, idToIndex, idBits, changedId,
-                                   xPrecision, yPrecision, downTime, classification);
-            return true;
-        };
-
-        auto handlePressGesture = [&]() -> bool {
-            // last_finger_count is set when press detected, used to identify press release gesture
-            static uint32_t last_finger_count = 0;
-            // last_press_time is used to detect press release time interval
-            // only update when press detected
-            static nsecs_t last_press_time = 0;
-
-            // press gesture detected when two or more fingers are putted on the touchpad
-            if (curr_gesture == PointerGestureMode::PRESS) {
-                last_finger_count = finger_count;
-                last_press_time = when;
-                LOGD("handlePressGesture: press detected, when=%lld", when);
-                return true;
-            }
-
-            if ((curr_gesture == PointerGestureMode::NEUTRAL || curr_gesture == PointerGestureMode::QUIET) &&
-                last_gesture == PointerGestureMode::PRESS && last_finger_count == 2) {
-                if (when - last_press_time <= 150 * 1000000LL) {         // 150 ms
-                    LOGD("handlePressGesture: press release detected, when=%lld", when);
-                    //transform pointer type to mouse, use a new properties array to avoid modifying the original one
-                    auto new_properties = *properties;
-                    new_properties.at(0).toolType = ToolType::MOUSE;
-                    //emulate press tap
-                    hookInstance->original(hookInstance, when, readTime, policyFlags, source,
-                                           AMOTION_EVENT_ACTION_DOWN, 0, flags, metaState,
-                                           AMOTION_EVENT_BUTTON_SECONDARY,
-                                           edgeFlags, &new_properties, coords, idToIndex, idBits, changedId,
-                                           xPrecision, yPrecision, downTime, classification);
-                    hookInstance->original(hookInstance, when, readTime, policyFlags, source,
-                                           AMOTION_EVENT_ACTION_BUTTON_PRESS, AMOTION_EVENT_BUTTON_SECONDARY, flags,
-                                           metaState,
-                                           AMOTION_EVENT_BUTTON_SECONDARY,
-                                           edgeFlags, &new_properties, coords, idToIndex, idBits, changedId,
-                                           xPrecision, yPrecision, downTime, classification);
-
-                    //emulate press release
-                    hookInstance->original(hookInstance, when, readTime, policyFlags, source,
-                                           AMOTION_EVENT_ACTION_BUTTON_RELEASE, AMOTION_EVENT_BUTTON_SECONDARY, flags,
-                                           metaState,
-                                           0,
-                                           edgeFlags, &new_properties, coords, idToIndex, idBits, changedId,
-                                           xPrecision, yPrecision, downTime, classification);
-                    hookInstance->original(hookInstance, when, readTime, policyFlags, source,
-                                           AMOTION_EVENT_ACTION_UP, 0, flags, metaState, 0,
-                                           edgeFlags, &new_properties, coords, idToIndex, idBits, changedId,
-                                           xPrecision, yPrecision, downTime, classification);
-
-                    LOGI("handlePressGesture: RIGHT_TAP, when=%lld", when);
-                    return true;
-
-                } else {
-                    LOGD("handlePressGesture: NOT A TAP, when=%lld", when);
-                    return true;
-                }
-
-            }
-            return false;
-        };
-
-        auto handleSwipeGesture = [&]() -> bool {
-            static float last_x = 0;
-            static float last_y = 0;
-            static float last_diff_x = 0;
-            static float last_diff_y = 0;
-            static float swipe_x = 0;
-            static float swipe_y = 0;
-            float curr_x = coords->at(0).getAxisValue(AMOTION_EVENT_AXIS_X);
-            float curr_y = coords->at(0).getAxisValue(AMOTION_EVENT_AXIS_Y);
-            float diff_x = last_x - curr_x, diff_y = last_y - curr_y;
-            Defer _d([&]() {
-                last_x = curr_x;
-                last_y = curr_y;
-                last_diff_x = diff_x == 0 ? last_diff_x : diff_x;
-                last_diff_y = diff_y == 0 ? last_diff_y : diff_y;
-            });
-
-            if (curr_gesture == PointerGestureMode::SWIPE) {
-                //transform pointer type to mouse, use a new properties array to avoid modifying the original one
-                auto new_properties = *properties;
-                new_properties.at(0).toolType = ToolType::MOUSE;
-
-                auto speedTransform = [](float speed) -> float {
-                    float s = abs(speed);
-                    float sign = speed > 0 ? 1.0f : -1.0f;
-                    if (s < 0.2)
-                        return 0;
-                    if (s < 0.5)
-                        return sign * (s * 1.1f);
-                    if (s < 2)
-                        return sign * (s * 1.25f);
-                    if (s > 80)
-                        return sign * 8.0f;
-                    return sign * 2.5f;
-                };
-                // avoid huge scroll when gesture triggered first time in this session
-                if (last_gesture != PointerGestureMode::SWIPE) {
-                    diff_x = 0;
-                    diff_y = 0;
-                    swipe_x = last_x;
-                    swipe_y = last_y;
-                } else {
-                    static size_t counter = 0;
-                    static float speedSum_x = 0;
-                    static float speedSum_y = 0;
-                    counter++;
-                    speedSum_x += speedTransform(diff_x);
-                    speedSum_y += speedTransform(diff_y);
-
-                    if (counter >= 2) {
-
-                        coords->at(0).setAxisValue(AMOTION_EVENT_AXIS_VSCROLL, speedSum_x * 0.2f);
-                        coords->at(0).setAxisValue(AMOTION_EVENT_AXIS_HSCROLL, speedSum_y * 0.2f);
-
-                        // lock scroll pointer to the first position
-                        coords->at(0).setAxisValue(AMOTION_EVENT_AXIS_X, swipe_x);
-                        coords->at(0).setAxisValue(AMOTION_EVENT_AXIS_Y, swipe_y);
-                        hookInstance->original(hookInstance, when, readTime, policyFlags, source,
-                                               AMOTION_EVENT_ACTION_HOVER_MOVE,
-                                               actionButton,
-                                               flags,
-                                               metaState, buttonState,
-                                               edgeFlags, &new_properties, coords, idToIndex, idBits, changedId,
-                                               xPrecision,
-                                               yPrecision,
-                                               downTime,
-                                               classification);
-                        hookInstance->original(hookInstance, when, readTime, policyFlags, source,
-                                               AMOTION_EVENT_ACTION_SCROLL, actionButton,
-                                               flags,
-                                               metaState, buttonState,
-                                               edgeFlags, &new_properties, coords, idToIndex, idBits, changedId,
-                                               xPrecision,
-                                               yPrecision,
-                                               downTime,
-                                               classification);
-                        counter = 0;
-                        speedSum_x = 0;
-                        speedSum_y = 0;
-                        LOGD("handleSwipeGesture: scroll dx:%0.3f dy:%0.3f a:%0.3f b:%0.3f", diff_x, diff_y,
-                             coords->at(0).getAxisValue(AMOTION_EVENT_AXIS_VSCROLL),
-                             coords->at(0).getAxisValue(AMOTION_EVENT_AXIS_HSCROLL));
-                    }
-                }
-                return true;
-            }
-
-            return false;
-        };
-
-        bool cancel_gesture = false;
-        if (enableGestureTransform) {
-            cancel_gesture = handlePressGesture() || cancel_gesture;
-            cancel_gesture = handleSwipeGesture() || cancel_gesture;
-            cancel_gesture = handleTapGesture() || cancel_gesture;
-            cancel_gesture = handleBtnClickDragGesture() || cancel_gesture;
-        }
-        handleModeSwitch();
-
-        // ==================== update state ====================
-        last_gesture = curr_gesture;
-        if (cancel_gesture) {
-            LOGD("inject: gesture canceled, when=%lld action=%d", when, action);
-            return;
-        } else {
-            return original(this, when, readTime, policyFlags, source, action, actionButton, flags, metaState,
-                            buttonState, edgeFlags, properties, coords, idToIndex, idBits, changedId,
-                            xPrecision, yPrecision, downTime, classification);
+    // every report of the pad would exhaust the rate limit of the site within a second, so log an even sample
+    LOGD_SAMPLED(8, "dispatchMotion(deviceId=%d deviceName=%s action=%s gestureMode=%s, last_gesture=%s count=%d)",
+         this->mDeviceContext->mDeviceId,
+         this->mDeviceContext->mDevice->mIdentifier.name.c_str(),
+         enums::actionName(action),
+         enums::name(in.mode),
+         enums::name(gestures->lastMode()),
+         in.fingerCount
+    );
+
+    gesture::Output out;
+    gestures->process(in, config::current(), out);
+
+    if (out.stopFling) {
+        fling::cancel();
+    }
+    if (out.fling) {
+        flingSource.deviceId = this->mDeviceContext->mDeviceId;
+        flingSource.eventHubId = this->mDeviceContext->mId;
+        flingSource.eventHub = this->mDeviceContext->mEventHub;
+        flingSource.policyFlags = policyFlags;
+        flingSource.source = source;
+        flingSource.flags = flags;
+        flingSource.metaState = metaState;
+        flingSource.edgeFlags = edgeFlags;
+        flingSource.changedId = changedId;
+        flingSource.xPrecision = xPrecision;
+        flingSource.yPrecision = yPrecision;
+        flingSource.x = out.x;
+        flingSource.y = out.y;
+        flingSource.idBits = idBits;
+        flingSource.classification = classification;
+        flingSource.properties = *properties;
+        flingSource.properties.at(0).toolType = ToolType::MOUSE;
+        flingSource.coords = *coords;
+        flingSource.idToIndex = *idToIndex;
+        fling::start(flingSource.deviceId, out.flingVx, out.flingVy, &wakeEventHub, flingSource.eventHub);
+    }
+
+    if (out.scroll) {
+        coords->at(0).setAxisValue(AMOTION_EVENT_AXIS_VSCROLL, out.vscroll);
+        coords->at(0).setAxisValue(AMOTION_EVENT_AXIS_HSCROLL, out.hscroll);
+        // lock scroll pointer to the first position
+        coords->at(0).setAxisValue(AMOTION_EVENT_AXIS_X, out.x);
+        coords->at(0).setAxisValue(AMOTION_EVENT_AXIS_Y, out.y);
+    }
+
+    if (out.count != 0) {
+        //transform pointer type to mouse, use a new properties array to avoid modifying the original one
+        auto new_properties = *properties;
+        new_properties.at(0).toolType = ToolType::MOUSE;
+        for (size_t i = 0; i < out.count; ++i) {
+            const gesture::Action &a = out.actions[i];
+            original(this, when, readTime, policyFlags, source, a.action, a.actionButton, flags, metaState,
+                     a.buttonState, edgeFlags, &new_properties, coords, idToIndex, idBits, changedId,
+                     xPrecision, yPrecision, downTime, classification);
         }
     }
 
+    if (out.cancel) {
+        LOGD("inject: gesture canceled, when=%" PRId64 " action=%d", when, action);
+        return;
+    }
     return original(this, when, readTime, policyFlags, source, action, actionButton, flags, metaState, buttonState,
                     edgeFlags, properties, coords, idToIndex, idBits, changedId, xPrecision, yPrecision, downTime,
                     classification);
-#pragma clang diagnostic pop
 }
 
+using DispatchMotionHook = THookTemplate<do_hash(DISPATCH_MOTION_SYM), do_hash(hooks::LIBINPUT_READER)>;
+
+// Dispatches the queued steps of the running fling as mouse scrolls, from the mapper's process() with the
+// reader holding InputReader::mLock, like every other dispatchMotion call.
+static void dispatchFlingSteps(android::TouchInputMapper *mapper) {
+    int32_t deviceId = mapper->mDeviceContext->mDeviceId;
+    for (fling::Step step; fling::poll(&step);) {
+        if (step.deviceId != deviceId || deviceId != flingSource.deviceId) continue;
+        timespec ts{};
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        nsecs_t now = ts.tv_sec * 1000000000LL + ts.tv_nsec;
+
+        PointerCoords &pointer = flingSource.coords.at(0);
+        pointer.setAxisValue(AMOTION_EVENT_AXIS_VSCROLL, step.vscroll);
+        pointer.setAxisValue(AMOTION_EVENT_AXIS_HSCROLL, step.hscroll);
+        pointer.setAxisValue(AMOTION_EVENT_AXIS_X, flingSource.x);
+        pointer.setAxisValue(AMOTION_EVENT_AXIS_Y, flingSource.y);
+        for (int32_t action : {AMOTION_EVENT_ACTION_HOVER_MOVE, AMOTION_EVENT_ACTION_SCROLL}) {
+            DispatchMotionHook::original(mapper, now, now, flingSource.policyFlags, flingSource.source,
+                                         action, 0, flingSource.flags, flingSource.metaState, 0,
+                                         flingSource.edgeFlags, &flingSource.properties, &flingSource.coords,
+                                         &flingSource.idToIndex, flingSource.idBits, flingSource.changedId,
+                                         flingSource.xPrecision, flingSource.yPrecision, now,
+                                         flingSource.classification);
+        }
+    }
+}
 
+// TouchInputMapper::process, only for attached mappers. Takes the synthetic fling event added by getEvents,
+// which processEventsLocked hands to the mappers of the device like any other; the rest goes to the original.
+static void touchProcess(android::TouchInputMapper *mapper, const android::RawEvent *rawEvent) {
+    if (rawEvent->type == FLING_EVENT_TYPE) {
+        dispatchFlingSteps(mapper);
+        return;
+    }
+    touchProcessOriginal(mapper, rawEvent);
+}
 
-
+// Adds the synthetic fling event while steps are queued, and only polls then, so that the steps a wake
+// brought the reader out for are dispatched and flushed by the same loopOnce. Runs on the reader thread,
+// outside mLock, and only fills the reader's own event buffer.
+TInstanceHook(size_t, hooks::LIBINPUT_READER, "_ZN7android8EventHub9getEventsEiPNS_8RawEventEm", android::EventHub,
+              int timeoutMillis, android::RawEvent *buffer, size_t bufferSize) {
+    size_t count = original(this, fling::pending() ? 0 : timeoutMillis, buffer, bufferSize);
+    if (count < bufferSize && fling::pending()) {
+        timespec ts{};
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        nsecs_t now = ts.tv_sec * 1000000000LL + ts.tv_nsec;
+        buffer[count++] = {now, now, flingSource.eventHubId, FLING_EVENT_TYPE, 0, 0};
+    }
+    return count;
+}
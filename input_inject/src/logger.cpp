@@ -0,0 +1,379 @@
+#include "logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <mutex>
+#include <new>
+#include <pthread.h>
+#include <unistd.h>
+#include "file_watcher.h"
+#include "spsc_ring.h"
+
+#if defined(__ANDROID__)
+#include <android/log.h>
+#endif
+
+#define LOG_TAG "InputInject/Logger"
+
+namespace {
+
+    constexpr size_t RING_SIZE = 64;
+    // after the last record, the drain thread keeps polling this long before it sleeps until woken
+    constexpr useconds_t POLL_INTERVAL_US = 5 * 1000;
+    constexpr int IDLE_POLLS = 20;
+
+    // One ring per logging thread. A ring is never freed: when its thread exits it is only released, so the
+    // drain thread can still read it and the next new thread can take it over.
+    struct ThreadRing {
+        SpscRing<logger::Record, RING_SIZE> ring;
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<bool> owned{true};
+        ThreadRing *next = nullptr;
+    };
+
+    std::atomic<ThreadRing *> rings{nullptr};
+    std::atomic<uint64_t> droppedTotal{0};
+    std::atomic<bool> sleeping{false};
+    std::once_flag drainOnce;
+
+    // every call site that has suppressed a record, sites are static so the list only grows
+    std::atomic<logger::Site *> sites{nullptr};
+    // set when a site suppressed its first record since the last report, the drain thread does not sleep then
+    std::atomic<bool> reportPending{false};
+    int64_t lastReport = 0;
+
+    void wakeDrain() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping.load(std::memory_order_relaxed)) {
+            sleeping.store(false, std::memory_order_relaxed);
+            sleeping.notify_one();
+        }
+    }
+
+    void sink(const logger::Record &record, const char *message) {
+#if !defined(__ANDROID__)
+        // stderr has no timestamps of its own, and the record reaches it some time after it was logged
+        static constexpr char levels[] = {'D', 'I', 'W', 'E'};
+        fprintf(stderr, "%lld.%06lld %c %s: %s\n", static_cast<long long>(record.time / 1000000000),
+                static_cast<long long>(record.time % 1000000000 / 1000), levels[static_cast<int>(record.level)],
+                record.tag, message);
+#else
+        logger::log(record.level, record.tag, message);
+#endif
+    }
+
+    // Reports the records suppressed by each site since the last report, at most every REPORT_INTERVAL_NS.
+    // Returns whether a report is still due.
+    bool reportSuppressed() {
+        if (!reportPending.load(std::memory_order_acquire)) return false;
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+        int64_t now = ts.tv_sec * 1000000000LL + ts.tv_nsec;
+        if (now - lastReport < logger::REPORT_INTERVAL_NS) return true;
+        lastReport = now;
+        // cleared first: a site that suppresses again after its count is taken below sets it again
+        reportPending.store(false, std::memory_order_relaxed);
+        char message[1024];
+        for (logger::Site *site = sites.load(std::memory_order_acquire); site != nullptr; site = site->next) {
+            uint32_t suppressed = site->suppressed.exchange(0, std::memory_order_relaxed);
+            if (suppressed == 0) continue;
+            snprintf(message, sizeof(message), "%u records suppressed by the rate limit: \"%s\"", suppressed, site->fmt);
+            logger::log(site->level, site->tag, message);
+        }
+        return false;
+    }
+
+    bool drainAll() {
+        bool any = false;
+        char message[1024];
+        for (ThreadRing *ring = rings.load(std::memory_order_acquire); ring != nullptr; ring = ring->next) {
+            for (logger::Record record; ring->ring.pop(&record);) {
+                logger::format(record, message, sizeof(message));
+                sink(record, message);
+                any = true;
+            }
+            uint64_t dropped = ring->dropped.exchange(0, std::memory_order_relaxed);
+            if (dropped != 0) {
+                droppedTotal.fetch_add(dropped, std::memory_order_relaxed);
+                snprintf(message, sizeof(message), "%llu log records dropped, ring full",
+                         static_cast<unsigned long long>(dropped));
+                logger::log(logger::LogLevel::WARN, LOG_TAG, message);
+            }
+        }
+        return any;
+    }
+
+    void *drainLoop(void *) {
+        pthread_setname_np(pthread_self(), "InputInjectLog");
+        for (;;) {
+            for (int idle = 0; idle < IDLE_POLLS;) {
+                bool any = drainAll();
+                idle = reportSuppressed() || any ? 0 : idle + 1;
+                usleep(POLL_INTERVAL_US);
+            }
+            // announce the sleep before the last check, so a record pushed after it always wakes us
+            sleeping.store(true, std::memory_order_seq_cst);
+            if (drainAll() || reportPending.load(std::memory_order_seq_cst)) {
+                sleeping.store(false, std::memory_order_relaxed);
+                continue;
+            }
+            sleeping.wait(true, std::memory_order_seq_cst);
+        }
+    }
+
+    void startDrain() {
+        pthread_t thread;
+        if (pthread_create(&thread, nullptr, drainLoop, nullptr) == 0) {
+            pthread_detach(thread);
+        }
+    }
+
+    ThreadRing *acquireRing() {
+        std::call_once(drainOnce, startDrain);
+        for (ThreadRing *ring = rings.load(std::memory_order_acquire); ring != nullptr; ring = ring->next) {
+            bool released = false;
+            if (ring->owned.compare_exchange_strong(released, true, std::memory_order_acquire)) return ring;
+        }
+        auto ring = new(std::nothrow) ThreadRing;
+        if (ring == nullptr) return nullptr;
+        ring->next = rings.load(std::memory_order_relaxed);
+        while (!rings.compare_exchange_weak(ring->next, ring, std::memory_order_release, std::memory_order_relaxed));
+        return ring;
+    }
+
+    // releases the ring of a thread when it exits
+    struct LocalRing {
+        ThreadRing *ring = nullptr;
+
+        ~LocalRing() {
+            if (ring != nullptr) ring->owned.store(false, std::memory_order_release);
+        }
+    };
+
+    thread_local LocalRing localRing;
+
+    // Appends the printf spec [begin, end) to `spec` with its length modifiers replaced by `length`.
+    void specWith(char *spec, const char *begin, const char *end, const char *length) {
+        size_t n = 0;
+        for (const char *p = begin; p < end - 1; ++p) {
+            if (strchr("hlLqjzt", *p) == nullptr) spec[n++] = *p;
+        }
+        for (const char *p = length; *p != '\0'; ++p) spec[n++] = *p;
+        spec[n++] = end[-1];
+        spec[n] = '\0';
+    }
+
+    // The size of the integer the length modifiers of the printf spec [begin, end) make printf read.
+    size_t lengthSize(const char *begin, const char *end) {
+        const char *p = begin;
+        while (p < end - 1 && strchr("hlLqjzt", *p) == nullptr) ++p;
+        switch (*p) {
+            case 'h': return p[1] == 'h' ? sizeof(char) : sizeof(short);
+            case 'l': return p[1] == 'l' ? sizeof(long long) : sizeof(long);
+            case 'L': case 'q': return sizeof(long long);
+            case 'j': return sizeof(intmax_t);
+            case 'z': return sizeof(size_t);
+            case 't': return sizeof(ptrdiff_t);
+            default: return sizeof(int);
+        }
+    }
+
+    // `value` cut to its low `size` bytes and extended back the way a signed or unsigned conversion reads them.
+    int64_t narrow(int64_t value, size_t size, bool isSigned) {
+        if (size >= sizeof(value)) return value;
+        const unsigned shift = 64 - 8 * size;
+        auto bits = static_cast<uint64_t>(value) << shift;
+        return isSigned ? static_cast<int64_t>(bits) >> shift : static_cast<int64_t>(bits >> shift);
+    }
+
+    constexpr uint64_t SLOT_MASK = logger::levelBits(logger::LogLevel::DEBUG);
+
+    // `mask` with the slot of `tag`, or every slot for "*", replaced by `bits`. False for an unknown tag.
+    bool withTag(uint64_t *mask, const char *tag, uint64_t bits) {
+        if (strcmp(tag, "*") == 0) {
+            *mask = logger::allTags(bits);
+            return true;
+        }
+        size_t index = logger::tagIndex(tag);
+        if (index == std::size(logger::TAGS)) return false;
+        *mask = (*mask & ~(SLOT_MASK << (index * logger::LEVEL_COUNT))) | bits << (index * logger::LEVEL_COUNT);
+        return true;
+    }
+
+    bool updateTag(const char *tag, uint64_t bits) {
+        uint64_t mask = logger::levels.load(std::memory_order_relaxed), next;
+        do {
+            next = mask;
+            if (!withTag(&next, tag, bits)) return false;
+        } while (!logger::levels.compare_exchange_weak(mask, next, std::memory_order_relaxed));
+        return true;
+    }
+
+    bool parseLevel(const char *name, uint64_t *bits) {
+        static constexpr const char *names[] = {"debug", "info", "warn", "error"};
+        for (size_t i = 0; i < std::size(names); ++i) {
+            if (strcmp(name, names[i]) == 0) {
+                *bits = logger::levelBits(static_cast<logger::LogLevel>(i));
+                return true;
+            }
+        }
+        if (strcmp(name, "off") == 0) {
+            *bits = 0;
+            return true;
+        }
+        return false;
+    }
+
+    void reloadLevels(const char *path) {
+        if (logger::loadLevels(path)) {
+            LOGI("reloaded %s", path);
+        }
+    }
+}
+
+namespace logger {
+
+    void submit(const Record &record) {
+        if (localRing.ring == nullptr) {
+            localRing.ring = acquireRing();
+            if (localRing.ring == nullptr) return;
+        }
+        if (!localRing.ring->ring.push(record)) {
+            localRing.ring->dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        wakeDrain();
+    }
+
+    void noteSuppressed(Site &site) {
+        if (!site.listed.exchange(true, std::memory_order_relaxed)) {
+            site.next = sites.load(std::memory_order_relaxed);
+            while (!sites.compare_exchange_weak(site.next, &site, std::memory_order_release,
+                                                std::memory_order_relaxed));
+        }
+        // release: the drain thread that sees the flag also sees the site in the list
+        reportPending.store(true, std::memory_order_release);
+        wakeDrain();
+    }
+
+    void format(const Record &record, char *buffer, size_t size) {
+        size_t used = 0, argIndex = 0;
+        auto room = [&] { return used < size ? size - used : 0; };
+        const char *p = record.fmt;
+        while (*p != '\0' && used + 1 < size) {
+            if (*p != '%') {
+                buffer[used++] = *p++;
+                continue;
+            }
+            if (p[1] == '%') {
+                buffer[used++] = '%';
+                p += 2;
+                continue;
+            }
+            const char *begin = p++;
+            while (*p != '\0' && strchr("-+ #0123456789.hlLqjzt", *p) != nullptr) ++p;
+            if (*p == '\0') break;
+            char conversion = *p++;
+            if (strchr("diuxXocfFeEgGaAsp", conversion) == nullptr) {
+                // '*' and unknown conversions are rejected at compile time; copied as they are, not consuming
+                // an argument, if one gets here through a runtime format
+                while (begin < p && used + 1 < size) buffer[used++] = *begin++;
+                continue;
+            }
+            if (argIndex == record.argc) break;
+            char spec[32];
+            if (p - begin >= static_cast<ptrdiff_t>(sizeof(spec) - 3)) break;
+            const size_t index = argIndex++;
+            const Arg &arg = record.args[index];
+            int n;
+            switch (conversion) {
+                case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': {
+                    // printf reads the smaller of the promoted argument and what the length modifier asks for
+                    size_t captured = size_t{1} << ((record.intSizes >> (2 * index)) & 3);
+                    bool isSigned = conversion == 'd' || conversion == 'i';
+                    int64_t value = narrow(arg.i, std::min(captured, lengthSize(begin, p)), isSigned);
+                    specWith(spec, begin, p, "ll");
+                    n = isSigned ? snprintf(buffer + used, room(), spec, static_cast<long long>(value))
+                                 : snprintf(buffer + used, room(), spec, static_cast<unsigned long long>(value));
+                    break;
+                }
+                case 'c':
+                    specWith(spec, begin, p, "");
+                    n = snprintf(buffer + used, room(), spec, static_cast<int>(arg.i));
+                    break;
+                case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+                    specWith(spec, begin, p, "");
+                    n = snprintf(buffer + used, room(), spec, arg.d);
+                    break;
+                case 's':
+                    specWith(spec, begin, p, "");
+                    n = snprintf(buffer + used, room(), spec, record.text + arg.text);
+                    break;
+                case 'p':
+                    specWith(spec, begin, p, "");
+                    n = snprintf(buffer + used, room(), spec, arg.p);
+                    break;
+                default:
+                    n = 0;
+                    break;
+            }
+            used += n > 0 ? static_cast<size_t>(n) : 0;
+        }
+        if (used >= size) used = size - 1;
+        buffer[used] = '\0';
+    }
+
+    bool setLevel(const char *tag, LogLevel minimum) {
+        return updateTag(tag, levelBits(minimum));
+    }
+
+    bool disable(const char *tag) {
+        return updateTag(tag, 0);
+    }
+
+    bool loadLevels(const char *path) {
+        FILE *file = fopen(path, "re");
+        if (file == nullptr) return false;
+        // a line removed from the file goes back to the default, so every load starts from it
+        uint64_t mask = allTags(levelBits(DEFAULT_LEVEL));
+        char line[128], tag[64], level[16];
+        int lineNumber = 0;
+        while (fgets(line, sizeof(line), file) != nullptr) {
+            lineNumber++;
+            const char *p = line;
+            while (isspace(static_cast<unsigned char>(*p))) ++p;
+            if (*p == '\0' || *p == '#') continue;
+            uint64_t bits;
+            if (sscanf(p, "%63s %15s", tag, level) != 2 || !parseLevel(level, &bits) || !withTag(&mask, tag, bits)) {
+                LOGW("%s:%d: ignoring \"%s\", expected \"<tag|*> <debug|info|warn|error|off>\"", path, lineNumber,
+                     tag);
+            }
+        }
+        fclose(file);
+        levels.store(mask, std::memory_order_relaxed);
+        return true;
+    }
+
+    void watchLevels(const char *path) {
+        if (loadLevels(path)) {
+            LOGI("loaded %s", path);
+        }
+        if (!watcher::add(path, reloadLevels)) LOGE("cannot watch %s, changes are not picked up", path);
+    }
+
+    uint64_t dropped() {
+        return droppedTotal.load(std::memory_order_relaxed);
+    }
+
+    void log(LogLevel logLevel, const char *tag, const char *msg) {
+#if !defined(__ANDROID__)
+        // host builds have no logcat
+        static constexpr char levels[] = {'D', 'I', 'W', 'E'};
+        fprintf(stderr, "%c %s: %s\n", levels[static_cast<int>(logLevel)], tag, msg);
+#else
+        static constexpr int priorities[] = {ANDROID_LOG_DEBUG, ANDROID_LOG_INFO, ANDROID_LOG_WARN, ANDROID_LOG_ERROR};
+        __android_log_print(priorities[static_cast<int>(logLevel)], tag, "%s", msg);
+#endif
+    }
+}
@@ -1,23 +1,56 @@
 #pragma once
 #include <string>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <cstdio>
-#include <cstdarg>
+#include <cstring>
+#include <ctime>
+#include <iterator>
+#include <type_traits>
+#include <sys/types.h>
 
-#ifdef DEBUG_OUTPUT
-#define LOGD(fmt, ...) logger::debug(LOG_TAG, fmt, ##__VA_ARGS__)
-#else
-#define LOGD(fmt, ...) logger::emptyFunc()
-#endif
+#define LOGD(fmt, ...) LOGGER_WRITE(logger::LogLevel::DEBUG, 1, fmt, ##__VA_ARGS__)
+#define LOGI(fmt, ...) LOGGER_WRITE(logger::LogLevel::INFO, 1, fmt, ##__VA_ARGS__)
+#define LOGW(fmt, ...) LOGGER_WRITE(logger::LogLevel::WARN, 1, fmt, ##__VA_ARGS__)
+#define LOGE(fmt, ...) LOGGER_WRITE(logger::LogLevel::ERROR, 1, fmt, ##__VA_ARGS__)
+
+// Log only every `every`-th call of the site, for lines that are expected on every event.
+#define LOGD_SAMPLED(every, fmt, ...) LOGGER_WRITE(logger::LogLevel::DEBUG, every, fmt, ##__VA_ARGS__)
+#define LOGI_SAMPLED(every, fmt, ...) LOGGER_WRITE(logger::LogLevel::INFO, every, fmt, ##__VA_ARGS__)
+#define LOGW_SAMPLED(every, fmt, ...) LOGGER_WRITE(logger::LogLevel::WARN, every, fmt, ##__VA_ARGS__)
+#define LOGE_SAMPLED(every, fmt, ...) LOGGER_WRITE(logger::LogLevel::ERROR, every, fmt, ##__VA_ARGS__)
 
-#define LOGI(fmt, ...) logger::info(LOG_TAG, fmt, ##__VA_ARGS__)
-#define LOGW(fmt, ...) logger::warn(LOG_TAG, fmt, ##__VA_ARGS__)
-#define LOGE(fmt, ...) logger::error(LOG_TAG, fmt, ##__VA_ARGS__)
+// A disabled call site costs one relaxed load and a branch, its arguments are not evaluated. An enabled one then
+// asks the rate limit of its site, which is constant initialized, so it needs no guard. checkFormat() is never
+// evaluated, it only lets the compiler check the arguments against the format.
+#define LOGGER_WRITE(level, every, fmt, ...)                                                               \
+    do {                                                                                                    \
+        static_assert(logger::formatSupported(fmt), "'*' width or precision cannot be logged");             \
+        if (logger::enabled(level, std::integral_constant<size_t, logger::tagIndex(LOG_TAG)>::value)) {     \
+            static logger::Site loggerSite(level, LOG_TAG, fmt, every);                                     \
+            if (logger::admit(loggerSite)) {                                                                \
+                (void) sizeof(logger::checkFormat(fmt, ##__VA_ARGS__));                                     \
+                logger::write(level, LOG_TAG, fmt, ##__VA_ARGS__);                                          \
+            }                                                                                               \
+        }                                                                                                   \
+    } while (0)
 
-#include <android/log.h>
+#ifndef INPUT_INJECT_LOG_LEVELS_PATH
+#if defined(__ANDROID__)
+#define INPUT_INJECT_LOG_LEVELS_PATH "/data/system/input_inject.loglevel"
+#else
+#define INPUT_INJECT_LOG_LEVELS_PATH "/tmp/input_inject.loglevel"
+#endif
+#endif
 
+// Logging is deferred: a call site only copies the format pointer, a timestamp and its arguments into a ring
+// of the calling thread, and a background thread formats the record and hands it to logcat (stderr on the
+// host). A full ring drops the record and counts it, the count is reported with the next records drained.
+// Format strings must be literals, string arguments are copied into the record and may be truncated.
 namespace logger {
 
-    enum class LogLevel {
+    enum class LogLevel : uint8_t {
         DEBUG = 0,
         INFO,
         WARN,
@@ -26,69 +59,258 @@ namespace logger {
 
     inline void emptyFunc() {}
 
-    void info(const char *tag, const char *fmt, ...);
+    // Every tag of the library. Each has its own enabled levels, tags missing here share the last slot.
+    constexpr const char *TAGS[] = {
+            "InputInject/Config",
+            "InputInject/CustomGesture",
+            "InputInject/Entry",
+            "InputInject/Fling",
+            "InputInject/Hooking",
+            "InputInject/Logger",
+            "InputInject/Recorder",
+            "InputInject/Resolver",
+            "InputInject/Scanner",
+            "InputInject/SymbolCache",
+            "InputInject/VTableHook",
+            "InputInject/Watcher",
+    };
+    constexpr size_t TAG_SLOTS = std::size(TAGS) + 1;
+    constexpr size_t LEVEL_COUNT = 4;
+    static_assert(TAG_SLOTS * LEVEL_COUNT <= 64, "the levels of all tags must fit in one word");
 
-    void warn(const char *tag, const char *fmt, ...);
+    constexpr size_t tagIndex(const char *tag) {
+        for (size_t i = 0; i < std::size(TAGS); ++i) {
+            const char *a = TAGS[i], *b = tag;
+            while (*a != '\0' && *a == *b) ++a, ++b;
+            if (*a == *b) return i;
+        }
+        return std::size(TAGS);
+    }
 
-    void error(const char *tag, const char *fmt, ...);
+    // Bits of one tag's slot for `minimum` and every level above it.
+    constexpr uint64_t levelBits(LogLevel minimum) {
+        return (0xFull << static_cast<int>(minimum)) & 0xF;
+    }
 
-    void debug(const char *tag, const char *fmt, ...);
+    constexpr uint64_t allTags(uint64_t bits) {
+        uint64_t mask = 0;
+        for (size_t i = 0; i < TAG_SLOTS; ++i) mask |= bits << (i * LEVEL_COUNT);
+        return mask;
+    }
 
-    void log(LogLevel logLevel, const char *tag, const char *msg);
+#ifdef DEBUG_OUTPUT
+    constexpr LogLevel DEFAULT_LEVEL = LogLevel::DEBUG;
+#else
+    constexpr LogLevel DEFAULT_LEVEL = LogLevel::INFO;
+#endif
+
+    // LEVEL_COUNT bits per tag slot, bit n set when level n is enabled.
+    inline std::atomic<uint64_t> levels{allTags(levelBits(DEFAULT_LEVEL))};
+
+    inline bool enabled(LogLevel level, size_t tag) {
+        return (levels.load(std::memory_order_relaxed) >> (tag * LEVEL_COUNT + static_cast<int>(level))) & 1;
+    }
+
+    // Enables `minimum` and above for `tag`, or for every tag if `tag` is "*". Returns false for an unknown tag.
+    bool setLevel(const char *tag, LogLevel minimum);
+
+    // Disables every level of `tag`, or of every tag if `tag` is "*". Returns false for an unknown tag.
+    bool disable(const char *tag);
+
+    // Applies a level file, one "<tag|*> <debug|info|warn|error|off>" per line, lines apply in order.
+    bool loadLevels(const char *path);
+
+    // Loads `path` and applies it again whenever it changes.
+    void watchLevels(const char *path);
+
+    // Every call site may log SITE_BURST records at once and SITE_RATE per second after that. Records over the
+    // budget are counted instead, and the drain thread reports the counts at most every REPORT_INTERVAL_NS.
+    constexpr int64_t SITE_BURST = 32;
+    constexpr int64_t SITE_RATE = 20;
+    constexpr int64_t SITE_INTERVAL_NS = 1000000000 / SITE_RATE;
+    constexpr int64_t REPORT_INTERVAL_NS = 1000000000;
+
+    // The rate limit of one call site, a token bucket kept as the time at which it is full again (GCRA).
+    struct Site {
+        constexpr Site(LogLevel level, const char *tag, const char *fmt, uint32_t sampleEvery) :
+                level(level), tag(tag), fmt(fmt), sampleEvery(sampleEvery) {}
+
+        const LogLevel level;
+        const char *const tag;
+        const char *const fmt;
+        const uint32_t sampleEvery;   // 1 logs every call
+        std::atomic<int64_t> full{0}; // CLOCK_MONOTONIC_COARSE ns
+        std::atomic<uint32_t> calls{0};
+        std::atomic<uint32_t> suppressed{0};
+        std::atomic<bool> listed{false};
+        Site *next = nullptr;
+    };
+
+    // Called when `site` suppresses its first record since the last report, lists it for the drain thread.
+    void noteSuppressed(Site &site);
+
+    // Whether a record of `site` may be logged now. Lock-free, a suppressed record costs a clock read and at most
+    // a few atomic operations. Calls skipped by sampling are not counted as suppressed.
+    inline bool admit(Site &site) {
+        if (site.sampleEvery > 1 && site.calls.fetch_add(1, std::memory_order_relaxed) % site.sampleEvery != 0) {
+            return false;
+        }
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+        int64_t now = ts.tv_sec * 1000000000LL + ts.tv_nsec;
+        int64_t full = site.full.load(std::memory_order_relaxed), next;
+        do {
+            int64_t start = full > now ? full : now;
+            if (start - now > (SITE_BURST - 1) * SITE_INTERVAL_NS) {
+                if (site.suppressed.fetch_add(1, std::memory_order_relaxed) == 0) noteSuppressed(site);
+                return false;
+            }
+            next = start + SITE_INTERVAL_NS;
+        } while (!site.full.compare_exchange_weak(full, next, std::memory_order_relaxed));
+        return true;
+    }
 
     inline pid_t currentPid = 0;
 
-    inline void info(const char *tag, const char *fmt, ...) {
-        va_list args;
-        va_start(args, fmt);
-        char buf[1024];
-        vsnprintf(buf, sizeof(buf), fmt, args);
-        va_end(args);
-        log(LogLevel::INFO, tag, buf);
+    constexpr size_t MAX_ARGS = 8;
+    constexpr size_t TEXT_SIZE = 160;
+
+    union Arg {
+        int64_t i;
+        double d;
+        const void *p;
+        uint32_t text; // offset of a copied string in Record::text
+    };
+
+    struct Record {
+        const char *tag;
+        const char *fmt;
+        int64_t time; // CLOCK_MONOTONIC ns
+        LogLevel level;
+        uint8_t argc;
+        uint16_t textUsed;
+        // 2 bits per argument, log2 of the size of an integer argument after promotion. Arg::i holds it sign or
+        // zero extended as its type is, and format() narrows it back the way printf reads a vararg.
+        uint16_t intSizes;
+        Arg args[MAX_ARGS];
+        char text[TEXT_SIZE];
+    };
+
+    static_assert(sizeof(Record) == 256);
+
+    int checkFormat(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+    // Whether format() supports every conversion of `fmt`. A '*' width or precision would need its int
+    // argument kept apart from the converted ones, so it is rejected at compile time instead.
+    constexpr bool formatSupported(const char *fmt) {
+        for (const char *p = fmt; *p != '\0'; ++p) {
+            if (*p != '%') continue;
+            if (p[1] == '%') {
+                ++p;
+                continue;
+            }
+            for (++p; *p != '\0' && std::char_traits<char>::find("-+ #0123456789.hlLqjzt*", 23, *p) != nullptr; ++p) {
+                if (*p == '*') return false;
+            }
+            if (*p == '\0') return true;
+        }
+        return true;
+    }
+
+    // Queues `record` on the calling thread's ring, never blocks.
+    void submit(const Record &record);
+
+    // Formats `record` into `buffer` the way printf would have.
+    void format(const Record &record, char *buffer, size_t size);
+
+    // Writes a formatted message to the sink, synchronously.
+    void log(LogLevel logLevel, const char *tag, const char *msg);
+
+    // Number of records dropped so far because a ring was full.
+    uint64_t dropped();
+
+    namespace detail {
+        inline void capture(Record &r, const char *s) {
+            Arg &arg = r.args[r.argc++];
+            // the last byte is kept as an empty string for arguments that no longer fit
+            if (r.textUsed >= TEXT_SIZE - 1) {
+                arg.text = TEXT_SIZE - 1;
+                r.text[TEXT_SIZE - 1] = '\0';
+                return;
+            }
+            if (s == nullptr) s = "(null)";
+            // a loop, not strnlen: GCC checks strnlen's bound against the size of a literal argument
+            size_t limit = TEXT_SIZE - 2 - r.textUsed, n = 0;
+            while (n < limit && s[n] != '\0') ++n;
+            arg.text = r.textUsed;
+            memcpy(r.text + r.textUsed, s, n);
+            r.text[r.textUsed + n] = '\0';
+            r.textUsed += n + 1;
+        }
+
+        inline void capture(Record &r, char *s) {
+            capture(r, static_cast<const char *>(s));
+        }
+
+        template<typename T>
+        inline void captureInt(Record &r, Arg &arg, T value) {
+            // the type printf would read the argument as after the default promotions
+            using Promoted = decltype(+value);
+            arg.i = static_cast<int64_t>(static_cast<Promoted>(value));
+            constexpr uint16_t sizeLog2 = sizeof(Promoted) == 8 ? 3 : sizeof(Promoted) == 4 ? 2 : 1;
+            r.intSizes |= sizeLog2 << (2 * (&arg - r.args));
+        }
+
+        template<typename T>
+        inline void capture(Record &r, T value) {
+            Arg &arg = r.args[r.argc++];
+            if constexpr (std::is_floating_point_v<T>) {
+                arg.d = value;
+            } else if constexpr (std::is_pointer_v<T>) {
+                arg.p = value;
+            } else if constexpr (std::is_enum_v<T>) {
+                captureInt(r, arg, static_cast<std::underlying_type_t<T>>(value));
+            } else {
+                static_assert(std::is_integral_v<T>, "cannot log this argument type");
+                captureInt(r, arg, value);
+            }
+        }
     }
 
-    inline void warn(const char *tag, const char *fmt, ...) {
-        va_list args;
-        va_start(args, fmt);
-        char buf[1024];
-        vsnprintf(buf, sizeof(buf), fmt, args);
-        va_end(args);
-        log(LogLevel::WARN, tag, buf);
+    template<typename... Args>
+    inline void write(LogLevel level, const char *tag, const char *fmt, Args... args) {
+        static_assert(sizeof...(Args) <= MAX_ARGS, "too many log arguments");
+        Record r;
+        r.tag = tag;
+        r.fmt = fmt;
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        r.time = ts.tv_sec * 1000000000LL + ts.tv_nsec;
+        r.level = level;
+        r.argc = 0;
+        r.textUsed = 0;
+        r.intSizes = 0;
+        (detail::capture(r, args), ...);
+        submit(r);
     }
 
-    inline void error(const char *tag, const char *fmt, ...) {
-        va_list args;
-        va_start(args, fmt);
-        char buf[1024];
-        vsnprintf(buf, sizeof(buf), fmt, args);
-        va_end(args);
-        log(LogLevel::ERROR, tag, buf);
+    template<typename... Args>
+    inline void info(const char *tag, const char *fmt, Args... args) {
+        if (enabled(LogLevel::INFO, tagIndex(tag))) write(LogLevel::INFO, tag, fmt, args...);
     }
 
-    inline void debug(const char *tag, const char *fmt, ...) {
-        va_list args;
-        va_start(args, fmt);
-        char buf[1024];
-        vsnprintf(buf, sizeof(buf), fmt, args);
-        va_end(args);
-        log(LogLevel::DEBUG, tag, buf);
+    template<typename... Args>
+    inline void warn(const char *tag, const char *fmt, Args... args) {
+        if (enabled(LogLevel::WARN, tagIndex(tag))) write(LogLevel::WARN, tag, fmt, args...);
     }
 
-    inline void log(LogLevel logLevel, const char *tag, const char *msg) {
-        switch (logLevel) {
-            case LogLevel::DEBUG:
-                __android_log_print(ANDROID_LOG_DEBUG, tag, "%s", msg);
-                break;
-            case LogLevel::INFO:
-                __android_log_print(ANDROID_LOG_INFO, tag, "%s", msg);
-                break;
-            case LogLevel::WARN:
-                __android_log_print(ANDROID_LOG_WARN, tag, "%s", msg);
-                break;
-            case LogLevel::ERROR:
-                __android_log_print(ANDROID_LOG_ERROR, tag, "%s", msg);
-                break;
-        }
-        return;
+    template<typename... Args>
+    inline void error(const char *tag, const char *fmt, Args... args) {
+        if (enabled(LogLevel::ERROR, tagIndex(tag))) write(LogLevel::ERROR, tag, fmt, args...);
+    }
+
+    template<typename... Args>
+    inline void debug(const char *tag, const char *fmt, Args... args) {
+        if (enabled(LogLevel::DEBUG, tagIndex(tag))) write(LogLevel::DEBUG, tag, fmt, args...);
     }
 }
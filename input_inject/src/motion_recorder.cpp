@@ -0,0 +1,141 @@
+#include "motion_recorder.h"
+
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <ctime>
+#include <limits>
+#include <mutex>
+#include <pthread.h>
+#include <unistd.h>
+#include "enum_names.h"
+#include "file_watcher.h"
+#include "logger.h"
+#include "spsc_ring.h"
+
+#define LOG_TAG "InputInject/Recorder"
+
+namespace {
+
+    // about four seconds of a 120 Hz pad, far more than the flush thread ever falls behind
+    constexpr size_t RING_SIZE = 512;
+    constexpr useconds_t FLUSH_INTERVAL_US = 50 * 1000;
+
+    SpscRing<recorder::Event, RING_SIZE> events; // reader -> flush thread
+    std::atomic<uint32_t> dropped{0};
+    std::once_flag threadOnce;
+    // when the current recording was asked for, set before `active` so the flush thread sees it with the flag
+    std::atomic<nsecs_t> startedAt{0};
+    // bumped by every start after `startedAt`, a stop and start between two flushes leave `active` as it was
+    std::atomic<uint32_t> generation{0};
+    constexpr nsecs_t NEVER = std::numeric_limits<nsecs_t>::max();
+
+    nsecs_t now() {
+        timespec ts{};
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    }
+
+    void writeEvent(FILE *out, const recorder::Event &event) {
+        fprintf(out, "%" PRId64 " %" PRId64 " %d %s %s %u 0x%08x", event.when, event.readTime, event.deviceId,
+                enums::actionName(event.action), enums::name(event.mode), event.fingerCount, event.idBits);
+        for (uint32_t i = 0; i < event.pointerCount; ++i) {
+            fprintf(out, " %.2f,%.2f", event.x[i], event.y[i]);
+        }
+        fputc('\n', out);
+    }
+
+    // Writes the queued events read in [from, until) to `out`, drops those read before `from` and leaves the
+    // rest queued.
+    void writeQueued(FILE *out, nsecs_t from, nsecs_t until) {
+        for (recorder::Event event; events.peek(&event) && event.readTime < until;) {
+            events.pop(&event);
+            if (out != nullptr && event.readTime >= from) writeEvent(out, event);
+        }
+        uint32_t lost = dropped.exchange(0, std::memory_order_relaxed);
+        if (out != nullptr && lost != 0) fprintf(out, "# %u events dropped, ring full\n", lost);
+    }
+
+    // Owns the recording: opens it when recording starts, appends the queued events every FLUSH_INTERVAL_US
+    // and closes it once recording stops or starts over. Sleeps while recording is off.
+    void *flushLoop(void *) {
+        pthread_setname_np(pthread_self(), "InputInjectRec");
+        FILE *out = nullptr;
+        uint32_t openGeneration = 0;
+        nsecs_t openedAt = 0;
+        for (;;) {
+            bool on = recorder::active.load(std::memory_order_acquire);
+            uint32_t current = generation.load(std::memory_order_acquire);
+            if (out != nullptr && (!on || current != openGeneration)) {
+                // the events read before a new start still belong to this recording
+                writeQueued(out, openedAt, on ? startedAt.load(std::memory_order_relaxed) : NEVER);
+                fclose(out);
+                out = nullptr;
+                LOGI("recording stopped");
+            }
+            if (!on) {
+                writeQueued(nullptr, NEVER, NEVER);
+                recorder::active.wait(false, std::memory_order_acquire);
+                continue;
+            }
+            if (out == nullptr) {
+                out = fopen(INPUT_INJECT_RECORDING_PATH, "we");
+                if (out == nullptr) {
+                    LOGW("cannot create %s (errno=%d), not recording", INPUT_INJECT_RECORDING_PATH, errno);
+                    recorder::active.store(false, std::memory_order_relaxed);
+                    continue;
+                }
+                fputs("# when read_time device action gesture_mode fingers id_bits x,y of each pointer by id\n", out);
+                LOGI("recording to %s", INPUT_INJECT_RECORDING_PATH);
+                openGeneration = current;
+                openedAt = startedAt.load(std::memory_order_relaxed);
+            }
+            // events left in the ring by the previous recording were read before this one was asked for
+            writeQueued(out, openedAt, NEVER);
+            fflush(out);
+            usleep(FLUSH_INTERVAL_US);
+        }
+    }
+
+    void startThread() {
+        pthread_t thread;
+        if (pthread_create(&thread, nullptr, flushLoop, nullptr) == 0) {
+            pthread_detach(thread);
+        }
+    }
+
+    void applyControl(const char *path) {
+        bool on = false;
+        if (FILE *file = fopen(path, "re")) {
+            int c = fgetc(file);
+            on = c == '1';
+            fclose(file);
+        }
+        if (on == recorder::active.load(std::memory_order_relaxed)) return;
+        if (on) {
+            std::call_once(threadOnce, startThread);
+            startedAt.store(now(), std::memory_order_relaxed);
+            generation.fetch_add(1, std::memory_order_release);
+        }
+        recorder::active.store(on, std::memory_order_release);
+        recorder::active.notify_one();
+    }
+}
+
+namespace recorder {
+
+    std::atomic<bool> active{false};
+
+    void record(const Event &event) {
+        if (!events.push(event)) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void watch(const char *controlPath) {
+        applyControl(controlPath);
+        if (!watcher::add(controlPath, applyControl)) {
+            LOGE("cannot watch %s, recording cannot be switched", controlPath);
+        }
+    }
+}
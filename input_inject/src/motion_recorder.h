@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "types.h"
+
+#ifndef INPUT_INJECT_RECORD_CONTROL_PATH
+#if defined(__ANDROID__)
+#define INPUT_INJECT_RECORD_CONTROL_PATH "/data/system/input_inject.record"
+#define INPUT_INJECT_RECORDING_PATH "/data/system/input_inject.recording"
+#else
+#define INPUT_INJECT_RECORD_CONTROL_PATH "/tmp/input_inject.record"
+#define INPUT_INJECT_RECORDING_PATH "/tmp/input_inject.recording"
+#endif
+#endif
+
+// Opt-in capture of what dispatchMotion of a touchpad was called with, to replay what the hook saw when a
+// gesture misbehaves. Writing "1" to the control file starts a new recording, "0" stops it. The reader thread
+// only copies events into a preallocated ring, a thread of the recorder writes them to the recording as text.
+namespace recorder {
+
+    struct Event {
+        nsecs_t when;
+        nsecs_t readTime;
+        int32_t deviceId;
+        int32_t action;
+        uint32_t idBits;
+        PointerGestureMode mode;
+        uint32_t fingerCount;
+        uint32_t pointerCount;
+        float x[MAX_POINTERS]; // of the pointers of idBits, in id order
+        float y[MAX_POINTERS];
+    };
+
+    extern std::atomic<bool> active;
+
+    inline bool recording() {
+        return active.load(std::memory_order_relaxed);
+    }
+
+    // Queues `event` for the recording, drops it if the ring is full. Reader thread only, never blocks.
+    void record(const Event &event);
+
+    // Applies the control file at `controlPath` and again whenever it changes.
+    void watch(const char *controlPath);
+}
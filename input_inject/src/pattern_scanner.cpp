@@ -0,0 +1,179 @@
+#include "pattern_scanner.h"
+
+#include <cstring>
+#include <link.h>
+#include "logger.h"
+#include "symbol_cache.h"
+#include "symbol_resolver.h"
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define LOG_TAG "InputInject/Scanner"
+
+namespace {
+
+    constexpr size_t MAX_SEGMENTS = 4;
+
+    struct TextSegments {
+        const char *module;
+        uintptr_t bias;
+        size_t count;
+        const uint8_t *begin[MAX_SEGMENTS];
+        const uint8_t *end[MAX_SEGMENTS];
+    };
+
+    int hexDigit(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    inline bool matchesAt(const uint8_t *p, const scanner::Pattern &pattern) {
+        for (size_t i = 0; i < pattern.size; ++i) {
+            if ((p[i] & pattern.mask[i]) != pattern.bytes[i]) return false;
+        }
+        return true;
+    }
+
+    const uint8_t *findScalar(const uint8_t *p, const uint8_t *last, const scanner::Pattern &pattern) {
+        for (; p <= last; ++p) {
+            if (matchesAt(p, pattern)) return p;
+        }
+        return nullptr;
+    }
+
+    int visitModule(dl_phdr_info *info, size_t, void *data) {
+        auto segments = static_cast<TextSegments *>(data);
+        if (info->dlpi_name == nullptr || !resolver::moduleMatches(info->dlpi_name, segments->module)) return 0;
+        segments->bias = info->dlpi_addr;
+        for (ElfW(Half) i = 0; i < info->dlpi_phnum && segments->count < MAX_SEGMENTS; ++i) {
+            const ElfW(Phdr) &phdr = info->dlpi_phdr[i];
+            if (phdr.p_type != PT_LOAD || (phdr.p_flags & PF_X) == 0) continue;
+            auto begin = reinterpret_cast<const uint8_t *>(info->dlpi_addr + phdr.p_vaddr);
+            segments->begin[segments->count] = begin;
+            segments->end[segments->count] = begin + phdr.p_memsz;
+            segments->count++;
+        }
+        return 1;
+    }
+}
+
+namespace scanner {
+
+    bool parse(const char *text, Pattern *out) {
+        out->size = 0;
+        for (const char *p = text; *p;) {
+            if (*p == ' ') {
+                ++p;
+                continue;
+            }
+            if (out->size == MAX_PATTERN) return false;
+            if (p[0] == '?') {
+                out->bytes[out->size] = 0;
+                out->mask[out->size] = 0;
+                p += p[1] == '?' ? 2 : 1;
+            } else {
+                int hi = hexDigit(p[0]), lo = hexDigit(p[1]);
+                if (hi < 0 || lo < 0) return false;
+                out->bytes[out->size] = static_cast<uint8_t>(hi << 4 | lo);
+                out->mask[out->size] = 0xFF;
+                p += 2;
+            }
+            out->size++;
+        }
+
+        size_t first = 0, last = out->size;
+        while (first < out->size && out->mask[first] == 0) ++first;
+        while (last > first && out->mask[last - 1] == 0) --last;
+        if (first == out->size) return false; // nothing but wildcards
+        out->first = first;
+        out->last = last - 1;
+        return true;
+    }
+
+    const uint8_t *find(const uint8_t *begin, const uint8_t *end, const Pattern &pattern) {
+        if (static_cast<size_t>(end - begin) < pattern.size) return nullptr;
+        const uint8_t *last = end - pattern.size; // last possible start of a match
+        const uint8_t *p = begin;
+
+        // Compare the two anchor bytes at 16 candidate positions at once and only verify the positions where
+        // both are equal. The anchor loads stay inside the pattern, so they never read past `end`.
+#if defined(__aarch64__)
+        const uint8x16_t first = vdupq_n_u8(pattern.bytes[pattern.first]);
+        const uint8x16_t second = vdupq_n_u8(pattern.bytes[pattern.last]);
+        for (; p + 15 <= last; p += 16) {
+            uint8x16_t eq = vandq_u8(vceqq_u8(vld1q_u8(p + pattern.first), first),
+                                     vceqq_u8(vld1q_u8(p + pattern.last), second));
+            // narrow each byte of the comparison to a nibble, the NEON stand-in for movemask
+            uint64_t bits = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+            while (bits != 0) {
+                size_t k = __builtin_ctzll(bits) >> 2;
+                if (matchesAt(p + k, pattern)) return p + k;
+                bits &= ~(0xFull << (k * 4));
+            }
+        }
+#elif defined(__SSE2__)
+        const __m128i first = _mm_set1_epi8(static_cast<char>(pattern.bytes[pattern.first]));
+        const __m128i second = _mm_set1_epi8(static_cast<char>(pattern.bytes[pattern.last]));
+        for (; p + 15 <= last; p += 16) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + pattern.first));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + pattern.last));
+            auto bits = static_cast<uint32_t>(_mm_movemask_epi8(
+                    _mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, second))));
+            while (bits != 0) {
+                size_t k = __builtin_ctz(bits);
+                if (matchesAt(p + k, pattern)) return p + k;
+                bits &= bits - 1;
+            }
+        }
+#endif
+        return findScalar(p, last, pattern);
+    }
+
+    void *findUnique(const char *module, const char *text) {
+        Pattern pattern;
+        if (!parse(text, &pattern)) {
+            LOGE("invalid pattern \"%s\"", text);
+            return nullptr;
+        }
+
+        TextSegments segments{module, 0, 0, {}, {}};
+        dl_iterate_phdr(visitModule, &segments);
+        if (segments.count == 0) {
+            LOGE("%s is not loaded", module);
+            return nullptr;
+        }
+
+        uint64_t buildKey = resolver::buildKey(module);
+        uint64_t rva;
+        if (symcache::get(buildKey, text, &rva)) {
+            auto cached = reinterpret_cast<const uint8_t *>(segments.bias + rva);
+            for (size_t i = 0; i < segments.count; ++i) {
+                if (cached >= segments.begin[i] && cached <= segments.end[i] - pattern.size
+                    && matchesAt(cached, pattern)) {
+                    return const_cast<uint8_t *>(cached);
+                }
+            }
+            LOGW("cached match of \"%s\" in %s no longer matches, scanning again", text, module);
+        }
+
+        const uint8_t *match = nullptr;
+        size_t matches = 0;
+        for (size_t i = 0; i < segments.count; ++i) {
+            for (const uint8_t *p = segments.begin[i]; (p = find(p, segments.end[i], pattern)) != nullptr; ++p) {
+                if (matches++ == 0) match = p;
+            }
+        }
+        if (matches != 1) {
+            LOGE("pattern \"%s\" has %zu matches in %s, expected exactly one", text, matches, module);
+            return nullptr;
+        }
+        symcache::put(buildKey, text, reinterpret_cast<uintptr_t>(match) - segments.bias);
+        return const_cast<uint8_t *>(match);
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Byte pattern search over the executable segments of a loaded module, for functions that a ROM does not export.
+// Patterns are written as hex bytes with `??` wildcards, e.g. "FD 7B ?? A9 FD 03 00 91".
+namespace scanner {
+
+    constexpr size_t MAX_PATTERN = 64;
+
+    struct Pattern {
+        uint8_t bytes[MAX_PATTERN];
+        uint8_t mask[MAX_PATTERN]; // 0xFF for a byte that must match, 0 for a wildcard
+        size_t size;
+        size_t first; // first and last byte that must match, the anchors of the vector search
+        size_t last;
+    };
+
+    bool parse(const char *text, Pattern *out);
+
+    // First match of `pattern` in [begin, end), or nullptr.
+    const uint8_t *find(const uint8_t *begin, const uint8_t *end, const Pattern &pattern);
+
+    // The address of the only match of `text` in the executable segments of `module`, or nullptr if there is
+    // no match or more than one. The result is kept in the symbol cache under the module's build-id.
+    void *findUnique(const char *module, const char *text);
+}
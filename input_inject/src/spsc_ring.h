@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+// Bounded single-producer single-consumer queue. push() and pop() never block or allocate: a full ring
+// rejects the item, an empty one returns false. Each side must stay on one thread.
+template<typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>);
+
+public:
+    // Producer side.
+    bool push(const T &item) {
+        size_t write = writeIndex.load(std::memory_order_relaxed);
+        if (write - readIndex.load(std::memory_order_acquire) == Capacity) return false;
+        items[write & (Capacity - 1)] = item;
+        writeIndex.store(write + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: the item pop() would return next, left in the ring.
+    bool peek(T *item) const {
+        size_t read = readIndex.load(std::memory_order_relaxed);
+        if (read == writeIndex.load(std::memory_order_acquire)) return false;
+        *item = items[read & (Capacity - 1)];
+        return true;
+    }
+
+    // Consumer side.
+    bool pop(T *item) {
+        size_t read = readIndex.load(std::memory_order_relaxed);
+        if (read == writeIndex.load(std::memory_order_acquire)) return false;
+        *item = items[read & (Capacity - 1)];
+        readIndex.store(read + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    // each index on its own cache line, so the two threads do not bounce one line between them
+    alignas(64) std::atomic<size_t> writeIndex{0};
+    alignas(64) std::atomic<size_t> readIndex{0};
+    alignas(64) T items[Capacity];
+};
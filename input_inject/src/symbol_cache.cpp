@@ -0,0 +1,120 @@
+#include "symbol_cache.h"
+
+#include <cstring>
+#include <mutex>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "logger.h"
+
+#define LOG_TAG "InputInject/SymbolCache"
+
+#ifndef INPUT_INJECT_CACHE_PATH
+#if defined(__ANDROID__)
+// writable by system_server, which hosts the input reader
+#define INPUT_INJECT_CACHE_PATH "/data/system/input_inject.cache"
+#else
+#define INPUT_INJECT_CACHE_PATH "/tmp/input_inject.cache"
+#endif
+#endif
+
+namespace {
+
+    constexpr uint32_t CACHE_MAGIC = 0x48434949; // "IICH"
+    constexpr uint32_t CACHE_VERSION = 1;
+    constexpr uint32_t CACHE_CAPACITY = 256; // power of two
+
+    struct Entry {
+        uint64_t key; // 0 for an empty slot
+        uint64_t value;
+    };
+
+    struct CacheFile {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t capacity;
+        uint32_t count;
+        Entry entries[CACHE_CAPACITY];
+    };
+
+    CacheFile *cache = nullptr;
+    std::once_flag cacheOnce;
+    std::mutex cacheLock;
+
+    void reset(CacheFile *file) {
+        memset(file->entries, 0, sizeof(file->entries));
+        file->count = 0;
+        file->capacity = CACHE_CAPACITY;
+        file->version = CACHE_VERSION;
+        file->magic = CACHE_MAGIC;
+    }
+
+    void openCache() {
+        int fd = ::open(INPUT_INJECT_CACHE_PATH, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+        if (fd < 0) {
+            LOGW("cannot open %s, symbols are resolved on every start", INPUT_INJECT_CACHE_PATH);
+            return;
+        }
+        struct stat st{};
+        bool fresh = fstat(fd, &st) != 0 || st.st_size != sizeof(CacheFile);
+        if (fresh && ftruncate(fd, sizeof(CacheFile)) != 0) {
+            close(fd);
+            return;
+        }
+        void *p = mmap(nullptr, sizeof(CacheFile), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) return;
+
+        auto file = static_cast<CacheFile *>(p);
+        if (fresh || file->magic != CACHE_MAGIC || file->version != CACHE_VERSION || file->capacity != CACHE_CAPACITY) {
+            reset(file);
+        }
+        LOGI("opened %s with %u entries", INPUT_INJECT_CACHE_PATH, file->count);
+        cache = file;
+    }
+
+    uint64_t keyOf(uint64_t buildKey, const char *name) {
+        uint64_t key = symcache::fnv1a(name, strlen(name), buildKey);
+        return key != 0 ? key : 1;
+    }
+
+    Entry *probe(uint64_t key) {
+        for (uint32_t i = 0, slot = key & (CACHE_CAPACITY - 1); i < CACHE_CAPACITY;
+             ++i, slot = (slot + 1) & (CACHE_CAPACITY - 1)) {
+            Entry &e = cache->entries[slot];
+            if (e.key == key || e.key == 0) return &e;
+        }
+        return nullptr;
+    }
+}
+
+namespace symcache {
+
+    bool get(uint64_t buildKey, const char *name, uint64_t *value) {
+        if (buildKey == 0) return false;
+        std::call_once(cacheOnce, openCache);
+        if (cache == nullptr) return false;
+
+        std::lock_guard<std::mutex> lock(cacheLock);
+        Entry *e = probe(keyOf(buildKey, name));
+        if (e == nullptr || e->key == 0) return false;
+        *value = e->value;
+        return true;
+    }
+
+    void put(uint64_t buildKey, const char *name, uint64_t value) {
+        if (buildKey == 0) return;
+        std::call_once(cacheOnce, openCache);
+        if (cache == nullptr) return;
+
+        std::lock_guard<std::mutex> lock(cacheLock);
+        uint64_t key = keyOf(buildKey, name);
+        // entries of superseded builds are never evicted one by one, start over once the table is half full
+        if (cache->count >= CACHE_CAPACITY / 2) reset(cache);
+        Entry *e = probe(key);
+        if (e->key == 0) cache->count++;
+        e->value = value;
+        e->key = key;
+    }
+}
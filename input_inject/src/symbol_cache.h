@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Persistent cache of resolved symbol RVAs and validated struct layouts, so that a restart of the input
+// service does no symbol lookups. It is a small open-addressing table in a memory-mapped file. Every key
+// is hashed together with the build-id of the module it belongs to, so entries of an older build of a
+// library simply stop matching once the library is updated.
+namespace symcache {
+
+    constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ull;
+    constexpr uint64_t FNV_PRIME = 0x100000001b3ull;
+
+    constexpr uint64_t fnv1a(const void *data, size_t size, uint64_t h) {
+        auto p = static_cast<const uint8_t *>(data);
+        for (size_t i = 0; i < size; ++i) {
+            h = (h ^ p[i]) * FNV_PRIME;
+        }
+        return h;
+    }
+
+    // The value stored for `name` under the module build key `buildKey`, see resolver::buildKey().
+    // Always misses for a build key of 0, that is a module without build-id.
+    bool get(uint64_t buildKey, const char *name, uint64_t *value);
+
+    void put(uint64_t buildKey, const char *name, uint64_t value);
+}
@@ -0,0 +1,184 @@
+#include "symbol_resolver.h"
+
+#include <cstring>
+#include <mutex>
+#include <dlfcn.h>
+#include <elf.h>
+#include <link.h>
+#include "logger.h"
+#include "symbol_cache.h"
+
+#define LOG_TAG "InputInject/Resolver"
+
+namespace {
+
+    constexpr size_t MAX_SEGMENTS = 8;
+
+    struct Segment {
+        ElfW(Addr) begin;
+        ElfW(Addr) end;
+        bool executable;
+    };
+
+    struct Module {
+        const char *name;
+        ElfW(Addr) bias;
+        const ElfW(Sym) *symtab;
+        const char *strtab;
+        // .gnu.hash: nbuckets, symoffset, bloom_size, bloom_shift, bloom[bloom_size], buckets[nbuckets], chain[]
+        const uint32_t *gnuHash;
+        uint64_t buildKey;
+        Segment segments[MAX_SEGMENTS]; // PT_LOAD, so a cached address can be checked against them
+        size_t segmentCount;
+    };
+
+    constexpr size_t MAX_MODULES = 8;
+    Module modules[MAX_MODULES];
+    size_t moduleCount = 0;
+    std::mutex modulesLock;
+
+    uint64_t hashBuildId(const dl_phdr_info *info) {
+        for (ElfW(Half) i = 0; i < info->dlpi_phnum; ++i) {
+            const ElfW(Phdr) &phdr = info->dlpi_phdr[i];
+            if (phdr.p_type != PT_NOTE) continue;
+            auto p = reinterpret_cast<const uint8_t *>(info->dlpi_addr + phdr.p_vaddr);
+            auto end = p + phdr.p_memsz;
+            while (p + sizeof(ElfW(Nhdr)) <= end) {
+                auto note = reinterpret_cast<const ElfW(Nhdr) *>(p);
+                auto name = p + sizeof(ElfW(Nhdr));
+                auto desc = name + ((note->n_namesz + 3) & ~3u);
+                if (note->n_type == NT_GNU_BUILD_ID && note->n_namesz == 4 && memcmp(name, "GNU", 4) == 0) {
+                    return symcache::fnv1a(desc, note->n_descsz, symcache::FNV_OFFSET);
+                }
+                p = desc + ((note->n_descsz + 3) & ~3u);
+            }
+        }
+        return 0;
+    }
+
+    struct Search {
+        const char *name;
+        Module *result;
+    };
+
+    int visitModule(dl_phdr_info *info, size_t, void *data) {
+        auto search = static_cast<Search *>(data);
+        if (info->dlpi_name == nullptr || !resolver::moduleMatches(info->dlpi_name, search->name)) return 0;
+
+        Module module{search->name, info->dlpi_addr, nullptr, nullptr, nullptr, hashBuildId(info), {}, 0};
+        for (ElfW(Half) i = 0; i < info->dlpi_phnum; ++i) {
+            const ElfW(Phdr) &phdr = info->dlpi_phdr[i];
+            if (phdr.p_type == PT_LOAD && module.segmentCount < MAX_SEGMENTS) {
+                ElfW(Addr) begin = info->dlpi_addr + phdr.p_vaddr;
+                module.segments[module.segmentCount++] = {begin, begin + phdr.p_memsz,
+                                                          (phdr.p_flags & PF_X) != 0};
+            }
+        }
+        for (ElfW(Half) i = 0; i < info->dlpi_phnum; ++i) {
+            if (info->dlpi_phdr[i].p_type != PT_DYNAMIC) continue;
+            auto dyn = reinterpret_cast<const ElfW(Dyn) *>(info->dlpi_addr + info->dlpi_phdr[i].p_vaddr);
+            for (; dyn->d_tag != DT_NULL; ++dyn) {
+                // glibc relocates the d_ptr entries of loaded modules in place, bionic leaves them as vaddrs
+                ElfW(Addr) p = dyn->d_un.d_ptr;
+                if (p < info->dlpi_addr) p += info->dlpi_addr;
+                switch (dyn->d_tag) {
+                    case DT_SYMTAB:
+                        module.symtab = reinterpret_cast<const ElfW(Sym) *>(p);
+                        break;
+                    case DT_STRTAB:
+                        module.strtab = reinterpret_cast<const char *>(p);
+                        break;
+                    case DT_GNU_HASH:
+                        module.gnuHash = reinterpret_cast<const uint32_t *>(p);
+                        break;
+                    default:
+                        break;
+                }
+            }
+        }
+        if (module.symtab == nullptr || module.strtab == nullptr || module.gnuHash == nullptr) {
+            LOGW("%s has no usable .gnu.hash", info->dlpi_name);
+            return 0;
+        }
+        if (moduleCount == MAX_MODULES) return 0;
+        modules[moduleCount] = module;
+        search->result = &modules[moduleCount++];
+        return 1;
+    }
+
+    Module *findModule(const char *name) {
+        std::lock_guard<std::mutex> lock(modulesLock);
+        for (size_t i = 0; i < moduleCount; ++i) {
+            if (strcmp(modules[i].name, name) == 0) return &modules[i];
+        }
+        Search search{name, nullptr};
+        dl_iterate_phdr(visitModule, &search);
+        return search.result;
+    }
+
+    bool inSegment(const Module *module, ElfW(Addr) address, resolver::SymbolKind kind) {
+        for (size_t i = 0; i < module->segmentCount; ++i) {
+            const Segment &segment = module->segments[i];
+            if (address >= segment.begin && address < segment.end) {
+                return segment.executable || kind == resolver::SymbolKind::DATA;
+            }
+        }
+        return false;
+    }
+
+    void *lookup(const Module *module, const char *sym, uint32_t hash) {
+        const uint32_t nbuckets = module->gnuHash[0];
+        const uint32_t symoffset = module->gnuHash[1];
+        const uint32_t bloomSize = module->gnuHash[2];
+        const uint32_t bloomShift = module->gnuHash[3];
+        auto bloom = reinterpret_cast<const ElfW(Addr) *>(module->gnuHash + 4);
+        auto buckets = reinterpret_cast<const uint32_t *>(bloom + bloomSize);
+        auto chain = buckets + nbuckets;
+
+        constexpr uint32_t bits = sizeof(ElfW(Addr)) * 8;
+        ElfW(Addr) word = bloom[(hash / bits) % bloomSize];
+        ElfW(Addr) mask = (ElfW(Addr)(1) << (hash % bits)) | (ElfW(Addr)(1) << ((hash >> bloomShift) % bits));
+        if ((word & mask) != mask) return nullptr;
+
+        uint32_t index = buckets[hash % nbuckets];
+        if (index < symoffset) return nullptr;
+        for (;; ++index) {
+            uint32_t chainHash = chain[index - symoffset];
+            const ElfW(Sym) &s = module->symtab[index];
+            if ((chainHash | 1) == (hash | 1) && s.st_shndx != SHN_UNDEF && strcmp(module->strtab + s.st_name, sym) == 0) {
+                return reinterpret_cast<void *>(module->bias + s.st_value);
+            }
+            if (chainHash & 1) return nullptr;
+        }
+    }
+}
+
+namespace resolver {
+
+    bool moduleMatches(const char *path, const char *name) {
+        size_t pathLen = strlen(path), nameLen = strlen(name);
+        if (pathLen < nameLen || strcmp(path + pathLen - nameLen, name) != 0) return false;
+        return pathLen == nameLen || path[pathLen - nameLen - 1] == '/';
+    }
+
+    void *findSymbol(const char *module, const char *sym, uint32_t hash, SymbolKind kind) {
+        if (Module *m = findModule(module); m != nullptr) {
+            uint64_t rva;
+            if (symcache::get(m->buildKey, sym, &rva)) {
+                if (inSegment(m, m->bias + rva, kind)) return reinterpret_cast<void *>(m->bias + rva);
+                LOGW("cached address of %s: %s is outside of its segments, looking it up again", module, sym);
+            }
+            if (void *p = lookup(m, sym, hash); p != nullptr) {
+                symcache::put(m->buildKey, sym, reinterpret_cast<uintptr_t>(p) - m->bias);
+                return p;
+            }
+        }
+        LOGD("falling back to dlsym for %s: %s", module, sym);
+        return dlsym(dlopen(module, RTLD_NOW), sym);
+    }
+
+    uint64_t buildKey(const char *module) {
+        Module *m = findModule(module);
+        return m != nullptr ? m->buildKey : 0;
+    }
+}
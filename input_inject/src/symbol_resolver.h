@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace resolver {
+
+    // The DT_GNU_HASH hash of a symbol name (djb2), computed at compile time for FixedString names.
+    constexpr uint32_t gnuHash(const char *name) {
+        uint32_t h = 5381;
+        for (size_t i = 0; name[i]; ++i) {
+            h = h * 33 + static_cast<uint8_t>(name[i]);
+        }
+        return h;
+    }
+
+    // Whether the path of a loaded module names the file `name`, which is matched as a whole path component.
+    bool moduleMatches(const char *path, const char *name);
+
+    // Where a symbol must lie: functions in an executable segment, objects such as vtables in any loaded one.
+    enum class SymbolKind {
+        CODE,
+        DATA,
+    };
+
+    // Looks up `sym` in the .gnu.hash and .dynsym of the loaded module whose file name is `module`.
+    // A cached address is only used if it lies in a segment of the module fitting `kind`, else `sym` is
+    // looked up again. Falls back to dlopen/dlsym when the module is not loaded yet or has no .gnu.hash section.
+    void *findSymbol(const char *module, const char *sym, uint32_t hash, SymbolKind kind = SymbolKind::CODE);
+
+    inline void *findSymbol(const char *module, const char *sym, SymbolKind kind = SymbolKind::CODE) {
+        return findSymbol(module, sym, gnuHash(sym), kind);
+    }
+
+    // A 64-bit FNV-1a hash of the NT_GNU_BUILD_ID note of the loaded module `module`, or 0 if it has none.
+    uint64_t buildKey(const char *module);
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cerrno>
+#include <cstddef>
 #include <cstdint>
 #include <array>
 
@@ -7,6 +9,15 @@
 #include "enums.h"
 
 using status_t = int32_t;
+
+namespace android {
+    // utils/Errors.h
+    enum : status_t {
+        OK = 0,
+        NO_MEMORY = -ENOMEM,
+        NAME_NOT_FOUND = -ENOENT,
+    };
+}
 using nsecs_t = int64_t;
 
 /*
@@ -47,14 +58,35 @@ struct PointerCoords {
     status_t setAxisValue(int32_t axis, float value);
 };
 
+// Same semantics as libinput's PointerCoords, but inlined: an axis is stored only while its bit is
+// marked in `bits`, and its value lives at the rank of that bit, the number of marked bits before it.
 inline float PointerCoords::getAxisValue(int32_t axis) const {
-    return SymCall(hooks::LIBINPUT, "_ZNK7android13PointerCoords12getAxisValueEi", float, const PointerCoords *,
-                   int32_t)(this, axis);
+    if (axis < 0 || axis > 63 || !android::BitSet64::hasBit(bits, axis)) {
+        return 0;
+    }
+    return values[android::BitSet64::getIndexOfBit(bits, axis)];
 }
 
-status_t PointerCoords::setAxisValue(int32_t axis, float value) {
-    return SymCall(hooks::LIBINPUT, "_ZN7android13PointerCoords12setAxisValueEif", status_t, PointerCoords *, int32_t,
-                   float)(this, axis, value);
+inline status_t PointerCoords::setAxisValue(int32_t axis, float value) {
+    if (axis < 0 || axis > 63) {
+        return android::NAME_NOT_FOUND;
+    }
+    uint32_t index = android::BitSet64::getIndexOfBit(bits, axis);
+    if (!android::BitSet64::hasBit(bits, axis)) {
+        if (value == 0) {
+            return android::OK; // axes with value 0 do not need to be stored
+        }
+        uint32_t count = android::BitSet64::count(bits);
+        if (count >= MAX_AXES) {
+            return android::NO_MEMORY;
+        }
+        android::BitSet64::markBit(bits, axis);
+        for (uint32_t i = count; i > index; i--) {
+            values[i] = values[i - 1];
+        }
+    }
+    values[index] = value;
+    return android::OK;
 }
 
 struct PointerProperties {
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "types.h"
+
+// Velocity of one pointer from its recent positions, by a least-squares line through the samples of the
+// last HORIZON, like the LSQ strategies of Android's VelocityTracker. A fixed ring, so adding a sample
+// never allocates and an estimate costs one pass over at most HISTORY samples.
+class VelocityTracker {
+public:
+    static constexpr size_t HISTORY = 16; // power of two
+    static constexpr nsecs_t HORIZON = 100 * 1000000LL;       // older samples are ignored
+    static constexpr nsecs_t ASSUME_STOPPED = 40 * 1000000LL; // a gap this long starts a new movement
+
+    void clear() { count = 0; }
+
+    void add(nsecs_t when, float x, float y) {
+        size_t i = head;
+        times[i] = when;
+        xs[i] = x;
+        ys[i] = y;
+        head = (head + 1) & (HISTORY - 1);
+        if (count < HISTORY) count++;
+    }
+
+    // Velocity in px/ms into vx and vy, false if fewer than two recent samples are known.
+    bool velocity(float *vx, float *vy) const {
+        if (count < 2) return false;
+        size_t newest = (head - 1) & (HISTORY - 1);
+        nsecs_t now = times[newest];
+        // sums over (t, x, y) with t in ms relative to the newest sample, which keeps them small in float
+        float n = 0, st = 0, stt = 0, sx = 0, sy = 0, stx = 0, sty = 0;
+        nsecs_t previous = now;
+        for (size_t k = 0; k < count; ++k) {
+            size_t i = (newest - k) & (HISTORY - 1);
+            if (now - times[i] > HORIZON || previous - times[i] > ASSUME_STOPPED) break;
+            previous = times[i];
+            float t = static_cast<float>(times[i] - now) * 1e-6f;
+            n += 1;
+            st += t;
+            stt += t * t;
+            sx += xs[i];
+            sy += ys[i];
+            stx += t * xs[i];
+            sty += t * ys[i];
+        }
+        float denominator = n * stt - st * st;
+        if (n < 2 || denominator < 1e-6f) return false;
+        *vx = (n * stx - st * sx) / denominator;
+        *vy = (n * sty - st * sy) / denominator;
+        return true;
+    }
+
+private:
+    nsecs_t times[HISTORY];
+    float xs[HISTORY];
+    float ys[HISTORY];
+    size_t head = 0;
+    size_t count = 0;
+};
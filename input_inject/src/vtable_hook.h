@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <dlfcn.h>
+#include "logger.h"
+#include "symbol_resolver.h"
+
+// Redirects virtual functions of chosen objects only. The vtable of the first attached object is cloned
+// once, the clone's slots are replaced, and attach() points an object's _vptr at the clone. Every other
+// object of the class keeps the stock vtable and runs the stock code.
+//
+// The clone is a copy of the whole vtable symbol, offset-to-top and typeinfo included, so dynamic_cast and
+// typeid keep working. Since the destructor of the object resets _vptr itself, owns() cannot match a
+// destroyed object or a new one allocated at the same address.
+class VTableHook {
+public:
+    static constexpr size_t MAX_WORDS = 512;
+    static constexpr size_t MAX_REDIRECTS = 8;
+
+    // Index of `methodSym` in the vtable `vtableSym` of `module`, counted from the address point, or -1.
+    static int slotOf(const char *module, const char *vtableSym, const char *methodSym) {
+        auto vtable = static_cast<void *const *>(resolver::findSymbol(module, vtableSym, resolver::SymbolKind::DATA));
+        auto method = resolver::findSymbol(module, methodSym);
+        size_t words = vtable != nullptr ? extent(vtable, nullptr) : 0;
+        if (words <= 2 || method == nullptr) {
+            logger::info("InputInject/VTableHook", "slot not found %s: %s", vtableSym, methodSym);
+            return -1;
+        }
+        // skip offset-to-top and typeinfo
+        for (size_t i = 2; i < words; ++i) {
+            if (vtable[i] == method) return static_cast<int>(i - 2);
+        }
+        logger::info("InputInject/VTableHook", "%s is not in %s", methodSym, vtableSym);
+        return -1;
+    }
+
+    // Replaces `slot` in the clone with `hook`, `original` receives the function of the attached object's class.
+    // May be called before or after the first attach(); repeated calls for the same slot are ignored.
+    void redirect(int slot, void *hook, void **original) {
+        if (slot < 0) return;
+        for (size_t i = 0; i < redirectCount; ++i) {
+            if (redirects[i].slot == slot) return;
+        }
+        if (redirectCount == MAX_REDIRECTS) return;
+        redirects[redirectCount++] = {slot, hook, original};
+        if (clone != nullptr) apply(redirects[redirectCount - 1]);
+    }
+
+    // Points `object` at the clone. Only objects with the same dynamic type as the first one can be attached.
+    bool attach(void *object) {
+        auto vptr = *static_cast<void ***>(object);
+        if (vptr == addressPoint) return true;
+        if (clone == nullptr && !cloneOf(vptr)) return false;
+        if (vptr != source) {
+            logger::info("InputInject/VTableHook", "%p has a different vtable %p, expected %p", object, vptr, source);
+            return false;
+        }
+        *static_cast<void ***>(object) = addressPoint;
+        return true;
+    }
+
+    inline bool owns(const void *object) const {
+        return *static_cast<void **const *>(object) == addressPoint;
+    }
+
+private:
+    struct Redirect {
+        int slot;
+        void *hook;
+        void **original;
+    };
+
+    void **clone = nullptr;
+    void **addressPoint = nullptr;
+    void **source = nullptr;
+    size_t words = 0;
+    Redirect redirects[MAX_REDIRECTS]{};
+    size_t redirectCount = 0;
+
+    // Number of words of the vtable symbol containing `p`, and its start in `start`. Relies on dladdr only
+    // matching an address inside the size of a symbol, which both bionic and glibc do.
+    static size_t extent(const void *p, void ***start) {
+        Dl_info info;
+        if (dladdr(p, &info) == 0 || info.dli_saddr == nullptr) return 0;
+        auto begin = static_cast<void **>(info.dli_saddr);
+        size_t n = static_cast<size_t>(static_cast<void *const *>(p) - begin) + 1;
+        Dl_info next;
+        while (n < MAX_WORDS && dladdr(begin + n, &next) != 0 && next.dli_saddr == info.dli_saddr) ++n;
+        if (start != nullptr) *start = begin;
+        return n;
+    }
+
+    bool cloneOf(void **vptr) {
+        void **start;
+        size_t n = extent(vptr, &start);
+        if (n == 0) {
+            logger::info("InputInject/VTableHook", "no vtable symbol at %p", vptr);
+            return false;
+        }
+        clone = static_cast<void **>(malloc(n * sizeof(void *)));
+        if (clone == nullptr) return false;
+        memcpy(clone, start, n * sizeof(void *));
+        words = n;
+        source = vptr;
+        addressPoint = clone + (vptr - start);
+        for (size_t i = 0; i < redirectCount; ++i) apply(redirects[i]);
+        logger::info("InputInject/VTableHook", "cloned vtable %p (%zu words) to %p", start, n, clone);
+        return true;
+    }
+
+    void apply(const Redirect &r) {
+        if (static_cast<size_t>(addressPoint - clone) + r.slot >= words) {
+            logger::info("InputInject/VTableHook", "slot %d is out of the vtable", r.slot);
+            return;
+        }
+        if (r.original != nullptr) *r.original = source[r.slot];
+        addressPoint[r.slot] = r.hook;
+    }
+};
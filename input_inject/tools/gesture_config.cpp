@@ -0,0 +1,143 @@
+// Compiles a text gesture config into the binary file mapped by input_inject, see gesture_config.h.
+//
+//   gesture_config <config.txt> <input_inject.gesture>
+//
+// The text has one `key = value` per line and `#` comments, keys that are left out keep their default.
+// The scroll curve is given by its control points, in px/ms of finger velocity to scroll units per ms:
+//
+//   curve = 0.024:0 0.06:0.066 0.24:0.3 7.2:0.3 12:0.96
+// The output is written next to the target and renamed over it, so a running input_inject never maps a
+// half-written file.
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "gesture_config.h"
+
+namespace {
+
+    enum class Kind {
+        MILLIS, // int64_t nanoseconds, written in milliseconds
+        FLOAT,
+        CURVE,  // control points "velocity:speed ...", sampled into curve and curveMaxVelocity
+    };
+
+    struct Key {
+        const char *name;
+        size_t offset;
+        Kind kind;
+    };
+
+    constexpr Key KEYS[] = {
+            {"tap_timeout_ms",        offsetof(config::GestureConfig, tapTimeout),         Kind::MILLIS},
+            {"triple_tap_timeout_ms", offsetof(config::GestureConfig, tripleTapTimeout),   Kind::MILLIS},
+            {"scroll_scale",          offsetof(config::GestureConfig, scrollScale),        Kind::FLOAT},
+            {"swipe_max_width_ratio", offsetof(config::GestureConfig, swipeMaxWidthRatio), Kind::FLOAT},
+            {"fling_time_constant_ms", offsetof(config::GestureConfig, flingTimeConstant), Kind::FLOAT},
+            {"fling_stop_velocity",   offsetof(config::GestureConfig, flingStopVelocity),  Kind::FLOAT},
+            {"curve",                 offsetof(config::GestureConfig, curve),              Kind::CURVE},
+    };
+
+    char *trim(char *s) {
+        while (*s == ' ' || *s == '\t') ++s;
+        char *end = s + strlen(s);
+        while (end > s && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\n' || end[-1] == '\r')) --end;
+        *end = '\0';
+        return s;
+    }
+
+    // Parses "v:s v:s ..." with increasing velocities into out.curve.
+    bool parseCurve(config::GestureConfig &out, const char *value) {
+        config::CurvePoint points[config::CURVE_SIZE];
+        size_t count = 0;
+        for (const char *p = value; *p != '\0';) {
+            char *end;
+            float velocity = strtof(p, &end);
+            if (end == p || *end != ':' || count == config::CURVE_SIZE) return false;
+            p = end + 1;
+            float speed = strtof(p, &end);
+            if (end == p) return false;
+            if (count != 0 && !(velocity > points[count - 1].velocity)) return false;
+            points[count++] = {velocity, speed};
+            for (p = end; *p == ' ' || *p == '\t'; ++p);
+        }
+        if (count == 0 || !(points[count - 1].velocity > 0.0f)) return false;
+        config::sampleCurve(points, count, out.curve);
+        out.curveMaxVelocity = points[count - 1].velocity;
+        return true;
+    }
+
+    bool assign(config::GestureConfig &out, const char *key, const char *value) {
+        for (const Key &k : KEYS) {
+            if (strcmp(k.name, key) != 0) continue;
+            if (k.kind == Kind::CURVE) return parseCurve(out, value);
+            char *end;
+            auto field = reinterpret_cast<char *>(&out) + k.offset;
+            if (k.kind == Kind::MILLIS) {
+                long long ms = strtoll(value, &end, 10);
+                int64_t ns = ms * 1000000LL;
+                memcpy(field, &ns, sizeof(ns));
+            } else {
+                float f = strtof(value, &end);
+                memcpy(field, &f, sizeof(f));
+            }
+            return end != value && *end == '\0';
+        }
+        return false;
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <config.txt> <output>\n", argv[0]);
+        return 2;
+    }
+    FILE *in = fopen(argv[1], "r");
+    if (in == nullptr) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    config::GestureConfig out = config::DEFAULTS;
+    char line[256];
+    int lineNo = 0;
+    bool ok = true;
+    while (fgets(line, sizeof(line), in) != nullptr) {
+        ++lineNo;
+        if (char *hash = strchr(line, '#')) *hash = '\0';
+        char *text = trim(line);
+        if (*text == '\0') continue;
+        char *eq = strchr(text, '=');
+        if (eq == nullptr) {
+            fprintf(stderr, "%s:%d: expected key = value\n", argv[1], lineNo);
+            ok = false;
+            continue;
+        }
+        *eq = '\0';
+        char *key = trim(text), *value = trim(eq + 1);
+        if (!assign(out, key, value)) {
+            fprintf(stderr, "%s:%d: unknown key or bad value \"%s = %s\"\n", argv[1], lineNo, key, value);
+            ok = false;
+        }
+    }
+    fclose(in);
+    if (!ok) return 1;
+    if (!config::validate(out, sizeof(out))) {
+        fprintf(stderr, "%s: values out of range\n", argv[1]);
+        return 1;
+    }
+
+    std::string tmp = std::string(argv[2]) + ".tmp";
+    FILE *file = fopen(tmp.c_str(), "wb");
+    if (file == nullptr || fwrite(&out, sizeof(out), 1, file) != 1 || fclose(file) != 0) {
+        perror(tmp.c_str());
+        return 1;
+    }
+    if (rename(tmp.c_str(), argv[2]) != 0) {
+        perror(argv[2]);
+        return 1;
+    }
+    return 0;
+}
@@ -27,7 +27,9 @@
  SOFTWARE.
  */
 #pragma once
-#define A64_MAX_BACKUPS 256
+
+#include <stdbool.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -36,6 +38,27 @@ extern "C" {
     void A64HookFunction(void *const symbol, void *const replace, void **result);
     void *A64HookFunctionV(void *const symbol, void *const replace,
                            void *const rwx, const uintptr_t rwx_size);
+    // Queues the code patches of subsequent A64HookFunction calls instead of applying them one by one.
+    // Trampolines are still built and returned immediately, but the hooks only take effect on commit.
+    // Calls nest, the patches are applied by the commit matching the outermost A64HookBegin.
+    void A64HookBegin();
+    // Applies the queued patches with one mprotect pair per page and one cache flush per patch,
+    // and reports the time since A64HookBegin. Returns the number of patches applied, 0 for an inner commit.
+    int A64HookCommit(uint64_t *elapsed_ns);
+    // Drops the patches queued since A64HookBegin without applying any of them. Their trampolines are kept.
+    void A64HookAbort();
+    // Restores the original prologue of a hooked `symbol` with a single atomic store. The trampoline and
+    // the entry island are kept, so callers that already took the branch or are still inside the replacement
+    // go on into the original function through them; waiting for those callers to leave is up to the caller.
+    // Fails for a patch that is not one aligned word, the absolute jump written when there was no room for
+    // an entry island, which a thread running the function could see half written.
+    bool A64UnhookFunction(void *const symbol);
+    // Writes the patch removed by A64UnhookFunction again, with the same trampoline. Fails like it.
+    bool A64RehookFunction(void *const symbol);
+    // Whether the patch of a hooked `symbol` is in place: committed, and not removed by A64UnhookFunction.
+    bool A64IsHooked(void *const symbol);
+    // Reports the address space mapped for trampolines and the bytes actually in use.
+    void A64GetTrampolineUsage(uintptr_t *mapped, uintptr_t *used);
 
 #ifdef __cplusplus
 }
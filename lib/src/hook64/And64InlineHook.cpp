@@ -33,11 +33,13 @@
 #include <string.h>
 #include <errno.h>
 #include <sys/mman.h>
-#include <android/log.h>
 
 #if defined(__aarch64__)
 
+#include <android/log.h>
+
 #include "hook64/And64InlineHook.hpp"
+#include "HookMemory.h"
 
 #define   A64_MAX_INSTRUCTIONS 5
 #define   A64_MAX_REFERENCES   (A64_MAX_INSTRUCTIONS * 2)
@@ -68,9 +70,16 @@ struct context {
     };
     int64_t basep;
     int64_t endp;
+    int64_t delta; // executable address - writable address of the output buffer
     insns_info dat[A64_MAX_INSTRUCTIONS];
 
 public:
+    // the address an output instruction will execute at, which differs from the
+    // address it is written through when trampolines are dual-mapped
+    inline int64_t pc(uint32_t *outp) {
+        return reinterpret_cast<int64_t>(outp) + this->delta;
+    }
+
     inline bool is_in_fixing_range(const int64_t absolute_addr) {
         return absolute_addr >= this->basep && absolute_addr < this->endp;
     }
@@ -125,6 +134,7 @@ public:
 #define __sync_cmpswap(p, v, n)    __sync_bool_compare_and_swap(p, v, n)
 #define __predict_true(exp)        __builtin_expect((exp) != 0, 1)
 #define __flush_cache(c, n)        __builtin___clear_cache(reinterpret_cast<char *>(c), reinterpret_cast<char *>(c) + n)
+#define __branch_range            ((1u << 27) - __page_size) // reach of "B" ADDR_PCREL26, minus some slack
 #define __make_rwx(p, n)           ::mprotect(__ptr_align(p), \
                                               __page_align(__uintval(p) + n) != __page_align(__uintval(p)) ? __page_align(n) + __page_size : __page_align(n), \
                                               PROT_READ | PROT_WRITE | PROT_EXEC)
@@ -147,7 +157,7 @@ static bool __fix_branch_imm(instruction inpp, instruction outpp, context *ctxp)
             int64_t absolute_addr = reinterpret_cast<int64_t>(*inpp) +
                                     (static_cast<int32_t>(ins << mbits) >> (mbits - 2u)); // sign-extended
             int64_t new_pc_offset =
-                    static_cast<int64_t>(absolute_addr - reinterpret_cast<int64_t>(*outpp)) >> 2; // shifted
+                    static_cast<int64_t>(absolute_addr - ctxp->pc(*outpp)) >> 2; // shifted
             bool special_fix_type = ctxp->is_in_fixing_range(absolute_addr);
             // whether the branch should be converted to absolute jump
             if (!special_fix_type && llabs(new_pc_offset) >= (rmask >> 1)) {
@@ -227,7 +237,7 @@ static bool __fix_cond_comp_test_branch(instruction inpp, instruction outpp, con
     intptr_t current_idx = ctxp->get_and_set_current_index(*inpp, *outpp);
     int64_t absolute_addr =
             reinterpret_cast<int64_t>(*inpp) + (static_cast<int32_t>((ins & ~lmask) << msb) >> (lsb - 2u + msb));
-    int64_t new_pc_offset = static_cast<int64_t>(absolute_addr - reinterpret_cast<int64_t>(*outpp)) >> 2; // shifted
+    int64_t new_pc_offset = static_cast<int64_t>(absolute_addr - ctxp->pc(*outpp)) >> 2; // shifted
     bool special_fix_type = ctxp->is_in_fixing_range(absolute_addr);
     if (!special_fix_type && llabs(new_pc_offset) >= (~lmask >> (lsb + 1))) {
         if ((reinterpret_cast<uint64_t>(*outpp + 4) & 7u) != 0u) {
@@ -306,7 +316,7 @@ static bool __fix_loadlit(instruction inpp, instruction outpp, context *ctxp) {
     intptr_t current_idx = ctxp->get_and_set_current_index(*inpp, *outpp);
     int64_t absolute_addr =
             reinterpret_cast<int64_t>(*inpp) + ((static_cast<int32_t>(ins << msb) >> (msb + lsb - 2u)) & ~3u);
-    int64_t new_pc_offset = static_cast<int64_t>(absolute_addr - reinterpret_cast<int64_t>(*outpp)) >> 2; // shifted
+    int64_t new_pc_offset = static_cast<int64_t>(absolute_addr - ctxp->pc(*outpp)) >> 2; // shifted
     bool special_fix_type = ctxp->is_in_fixing_range(absolute_addr);
     // special_fix_type may encounter issue when there are mixed data and code
     if (special_fix_type ||
@@ -327,7 +337,7 @@ static bool __fix_loadlit(instruction inpp, instruction outpp, context *ctxp) {
         faligned >>= 2; // new_pc_offset is shifted and 4-byte aligned
         while ((new_pc_offset & faligned) != 0) {
             *(*outpp)++ = A64_NOP;
-            new_pc_offset = static_cast<int64_t>(absolute_addr - reinterpret_cast<int64_t>(*outpp)) >> 2;
+            new_pc_offset = static_cast<int64_t>(absolute_addr - ctxp->pc(*outpp)) >> 2;
         }
         ctxp->reset_current_ins(current_idx, *outpp);
 
@@ -362,7 +372,7 @@ static bool __fix_pcreladdr(instruction inpp, instruction outpp, context *ctxp)
             int64_t lsb_bytes = static_cast<uint32_t>(ins << 1u) >> 30u;
             int64_t absolute_addr = reinterpret_cast<int64_t>(*inpp) +
                                     (((static_cast<int32_t>(ins << msb) >> (msb + lsb - 2u)) & ~3u) | lsb_bytes);
-            int64_t new_pc_offset = static_cast<int64_t>(absolute_addr - reinterpret_cast<int64_t>(*outpp));
+            int64_t new_pc_offset = static_cast<int64_t>(absolute_addr - ctxp->pc(*outpp));
             bool special_fix_type = ctxp->is_in_fixing_range(absolute_addr);
             if (!special_fix_type && llabs(new_pc_offset) >= (max_val >> 1)) {
                 if ((reinterpret_cast<uint64_t>(*outpp + 2) & 7u) != 0u) {
@@ -435,10 +445,15 @@ static bool __fix_pcreladdr(instruction inpp, instruction outpp, context *ctxp)
 
 //-------------------------------------------------------------------------
 
-static void __fix_instructions(uint32_t *__restrict inp, int32_t count, uint32_t *__restrict outp) {
+// Returns the number of bytes written to `outp`, including the jump back to the original code.
+// `outp` is the executable address; the instructions are stored through its writable alias.
+static uintptr_t __fix_instructions(uint32_t *__restrict inp, int32_t count, uint32_t *__restrict outp) {
     context ctx;
     ctx.basep = reinterpret_cast<int64_t>(inp);
     ctx.endp = reinterpret_cast<int64_t>(inp + count);
+    uint32_t *const outp_exec = outp;
+    outp = static_cast<uint32_t *>(HookWritable(outp_exec));
+    ctx.delta = reinterpret_cast<int64_t>(outp_exec) - reinterpret_cast<int64_t>(outp);
     memset(ctx.dat, 0, sizeof(ctx.dat));
     static_assert(sizeof(ctx.dat) / sizeof(ctx.dat[0]) == A64_MAX_INSTRUCTIONS,
                   "please use A64_MAX_INSTRUCTIONS!");
@@ -463,7 +478,7 @@ static void __fix_instructions(uint32_t *__restrict inp, int32_t count, uint32_t
 
     static constexpr uint_fast64_t mask = 0x03ffffffu; // 0b00000011111111111111111111111111
     auto callback = reinterpret_cast<int64_t>(inp);
-    auto pc_offset = static_cast<int64_t>(callback - reinterpret_cast<int64_t>(outp)) >> 2;
+    auto pc_offset = static_cast<int64_t>(callback - ctx.pc(outp)) >> 2;
     if (llabs(pc_offset) >= (mask >> 1)) {
         if ((reinterpret_cast<uint64_t>(outp + 2) & 7u) != 0u) {
             outp[0] = A64_NOP;
@@ -479,44 +494,21 @@ static void __fix_instructions(uint32_t *__restrict inp, int32_t count, uint32_t
     } //if
 
     const uintptr_t total = (outp - outp_base) * sizeof(uint32_t);
-    __flush_cache(outp_base, total); // necessary
+    __flush_cache(outp_exec, total); // necessary
+    return total;
 }
 
 //-------------------------------------------------------------------------
 
 extern "C" {
-static __attribute__((__aligned__(__page_size))) uint32_t __insns_pool[A64_MAX_BACKUPS][A64_MAX_INSTRUCTIONS * 10];
-
-//-------------------------------------------------------------------------
-
-class A64HookInit {
-public:
-    A64HookInit() {
-        __make_rwx(__insns_pool, sizeof(__insns_pool));
-        A64_LOGI("insns pool initialized.");
-    }
-};
-static A64HookInit __init;
-
-//-------------------------------------------------------------------------
-
-static uint32_t *FastAllocateTrampoline() {
-    static_assert((A64_MAX_INSTRUCTIONS * 10 * sizeof(uint32_t)) % 8 == 0, "8-byte align");
-    static volatile int32_t __index = -1;
-
-    int32_t i = __atomic_increase(&__index);
-    if (__predict_true(i >= 0 && i < __countof(__insns_pool))) {
-        return __insns_pool[i];
-    } //if
 
-    A64_LOGE("failed to allocate trampoline!");
-    return NULL;
-}
+// Worst-case reservation for a trampoline; the unused tail is returned to the arena afterwards.
+static constexpr uintptr_t __trampoline_reserve = A64_MAX_INSTRUCTIONS * 10u * sizeof(uint32_t);
 
 //-------------------------------------------------------------------------
 
-A64_JNIEXPORT void *A64HookFunctionV(void *const symbol, void *const replace,
-                                     void *const rwx, const uintptr_t rwx_size) {
+static void *__hook_function_v(void *const symbol, void *const replace,
+                               void *const rwx, const uintptr_t rwx_size, uintptr_t *used) {
     static constexpr uint_fast64_t mask = 0x03ffffffu; // 0b00000011111111111111111111111111
 
     uint32_t *trampoline = static_cast<uint32_t *>(rwx), *original = static_cast<uint32_t *>(symbol);
@@ -530,25 +522,27 @@ A64_JNIEXPORT void *A64HookFunctionV(void *const symbol, void *const replace,
                 A64_LOGE("rwx size is too small to hold %u bytes backup instructions!", count * 10u);
                 return NULL;
             } //if
-            __fix_instructions(original, count, trampoline);
+            uintptr_t total = __fix_instructions(original, count, trampoline);
+            if (used != NULL) *used = total;
         } //if
 
-        if (__make_rwx(original, 5 * sizeof(uint32_t)) == 0) {
-            if (count == 5) {
-                original[0] = A64_NOP;
-                ++original;
-            } //if
-            original[0] = 0x58000051u; // LDR X17, #0x8
-            original[1] = 0xd61f0220u; // BR X17
-            *reinterpret_cast<int64_t *>(original + 2) = __intval(replace);
-            __flush_cache(symbol, 5 * sizeof(uint32_t));
-
-            A64_LOGI("inline hook %p->%p successfully! %zu bytes overwritten",
-                     symbol, replace, 5 * sizeof(uint32_t));
-        } else {
-            A64_LOGE("mprotect failed with errno = %d, p = %p, size = %zu",
-                     errno, original, 5 * sizeof(uint32_t));
+        uint32_t patch[5], *p = patch;
+        if (count == 5) {
+            *p++ = A64_NOP;
+        } //if
+        p[0] = 0x58000051u; // LDR X17, #0x8
+        p[1] = 0xd61f0220u; // BR X17
+        const int64_t target = __intval(replace);
+        memcpy(p + 2, &target, sizeof(target));
+        const bool queued = HookBatchIsOpen();
+        if (!HookPatchText(original, patch, count * sizeof(uint32_t))) {
             trampoline = NULL;
+        } else if (queued) {
+            A64_LOGI("inline hook %p->%p queued, %zu bytes to overwrite on commit",
+                     symbol, replace, count * sizeof(uint32_t));
+        } else {
+            A64_LOGI("inline hook %p->%p successfully! %zu bytes overwritten",
+                     symbol, replace, count * sizeof(uint32_t));
         } //if
     } else {
         if (trampoline) {
@@ -556,19 +550,20 @@ A64_JNIEXPORT void *A64HookFunctionV(void *const symbol, void *const replace,
                 A64_LOGE("rwx size is too small to hold %u bytes backup instructions!", 1u * 10u);
                 return NULL;
             } //if
-            __fix_instructions(original, 1, trampoline);
+            uintptr_t total = __fix_instructions(original, 1, trampoline);
+            if (used != NULL) *used = total;
         } //if
 
-        if (__make_rwx(original, 1 * sizeof(uint32_t)) == 0) {
-            __sync_cmpswap(original, *original, 0x14000000u | (pc_offset & mask)); // "B" ADDR_PCREL26
-            __flush_cache(symbol, 1 * sizeof(uint32_t));
-
-            A64_LOGI("inline hook %p->%p successfully! %zu bytes overwritten",
+        const uint32_t patch = 0x14000000u | (pc_offset & mask); // "B" ADDR_PCREL26
+        const bool queued = HookBatchIsOpen();
+        if (!HookPatchText(original, &patch, 1 * sizeof(uint32_t))) {
+            trampoline = NULL;
+        } else if (queued) {
+            A64_LOGI("inline hook %p->%p queued, %zu bytes to overwrite on commit",
                      symbol, replace, 1 * sizeof(uint32_t));
         } else {
-            A64_LOGE("mprotect failed with errno = %d, p = %p, size = %zu",
-                     errno, original, 1 * sizeof(uint32_t));
-            trampoline = NULL;
+            A64_LOGI("inline hook %p->%p successfully! %zu bytes overwritten",
+                     symbol, replace, 1 * sizeof(uint32_t));
         } //if
     } //if
 
@@ -577,18 +572,62 @@ A64_JNIEXPORT void *A64HookFunctionV(void *const symbol, void *const replace,
 
 //-------------------------------------------------------------------------
 
+// "LDR X17, #0x8; BR X17; .quad replace"
+static constexpr uintptr_t __island_size = 4u * sizeof(uint32_t);
+
+// Maps an entry island within "B" reach of `symbol` that jumps on to `replace`, so the entry can be
+// patched with a single "B" however far away `replace` is. NULL if there is no free page near `symbol`.
+static void *__entry_island(void *const symbol, void *const replace) {
+    auto island = static_cast<uint32_t *>(HookAllocateNear(symbol, __island_size, __branch_range));
+    if (island == NULL) return NULL;
+    auto code = static_cast<uint32_t *>(HookWritable(island));
+    code[0] = 0x58000051u; // LDR X17, #0x8
+    code[1] = 0xd61f0220u; // BR X17
+    const int64_t target = __intval(replace);
+    memcpy(code + 2, &target, sizeof(target)); // 8-byte aligned, islands are 16-byte aligned
+    __flush_cache(island, __island_size);
+    return island;
+}
+
+//-------------------------------------------------------------------------
+
+A64_JNIEXPORT void *A64HookFunctionV(void *const symbol, void *const replace,
+                                     void *const rwx, const uintptr_t rwx_size) {
+    return __hook_function_v(symbol, replace, rwx, rwx_size, NULL);
+}
+
+//-------------------------------------------------------------------------
+
 A64_JNIEXPORT void A64HookFunction(void *const symbol, void *const replace, void **result) {
+    // allocated before the trampoline, which can only give back its unused tail while it is the latest allocation
+    void *target = replace;
+    if (llabs((__intval(replace) - __intval(symbol)) >> 2) >= (0x03ffffff >> 1)) {
+        target = __entry_island(symbol, replace);
+        if (target == NULL) {
+            A64_LOGI("no free page near %p, the entry is patched with an absolute jump", symbol);
+            target = replace;
+        } //if
+    } //if
+
     void *trampoline = NULL;
     if (result != NULL) {
-        trampoline = FastAllocateTrampoline();
+        // next to the symbol, so that the trampoline jumps back to the rest of it with a single "B"
+        trampoline = HookAllocateNear(symbol, __trampoline_reserve, __branch_range);
+        if (trampoline == NULL) {
+            A64_LOGI("no free page near %p, the trampoline returns with an absolute jump", symbol);
+            trampoline = HookAllocate(__trampoline_reserve);
+        } //if
         *result = trampoline;
-        if (trampoline == NULL) return;
+        if (trampoline == NULL) {
+            A64_LOGE("failed to allocate trampoline!");
+            return;
+        } //if
     } //if
 
-    // fix Android 10 .text segment is read-only by default
-    __make_rwx(symbol, 5 * sizeof(size_t));
-
-    trampoline = A64HookFunctionV(symbol, replace, trampoline, A64_MAX_INSTRUCTIONS * 10u);
+    uintptr_t used = 0;
+    void *const reserved = trampoline;
+    trampoline = __hook_function_v(symbol, target, trampoline, __trampoline_reserve, &used);
+    HookShrink(reserved, __trampoline_reserve, used);
     if (trampoline == NULL && result != NULL) {
         *result = NULL;
     } //if
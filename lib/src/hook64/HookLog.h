@@ -0,0 +1,22 @@
+#pragma once
+
+#if defined(__ANDROID__)
+#include <android/log.h>
+#define   HOOK_LOG(prio, ...)  ((void)__android_log_print(prio, "Hooking", __VA_ARGS__))
+#define   HOOK_PRIO_ERROR      ANDROID_LOG_ERROR
+#define   HOOK_PRIO_INFO       ANDROID_LOG_INFO
+#else
+#include <stdio.h>
+// host builds have no logcat, write to stderr instead
+#define   HOOK_LOG(prio, ...)  ((void)(fprintf(stderr, "%s Hooking: ", prio), fprintf(stderr, __VA_ARGS__), fputc('\n', stderr)))
+#define   HOOK_PRIO_ERROR      "E"
+#define   HOOK_PRIO_INFO       "I"
+#endif // defined(__ANDROID__)
+
+#ifndef DEBUG_OUTPUT
+#define   HOOK_LOGE(...)       HOOK_LOG(HOOK_PRIO_ERROR, __VA_ARGS__)
+#define   HOOK_LOGI(...)       HOOK_LOG(HOOK_PRIO_INFO, __VA_ARGS__)
+#else
+# define  HOOK_LOGI(...)       ((void)0)
+# define  HOOK_LOGE(...)       ((void)0)
+#endif // DEBUG_OUTPUT
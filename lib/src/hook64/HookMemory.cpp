@@ -0,0 +1,592 @@
+#define  __STDC_FORMAT_MACROS
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+#include "hook64/And64InlineHook.hpp"
+#include "HookLog.h"
+#include "HookMemory.h"
+
+#define   HOOK_PAGE_SIZE       4096
+#define   HOOK_ALIGN           16
+#define   HOOK_CHUNK_SIZE      HOOK_PAGE_SIZE
+#define   HOOK_MIN_ADDR        0x10000 // keep away from mmap_min_addr
+
+#define __align_up(x, n)           (((x) + ((n) - 1)) & ~((n) - 1))
+#define __align_down(x, n)         ((x) & -(n))
+
+//-------------------------------------------------------------------------
+
+struct hook_chunk {
+    hook_chunk *next;
+    uintptr_t   base;  // executable view
+    uintptr_t   wbase; // writable view of the same pages, equal to base for RWX chunks
+    size_t      size;
+    size_t      used;
+};
+
+struct hook_patch {
+    uintptr_t addr;
+    size_t    size;
+    bool      applied; // set by __apply_patches
+    uint8_t   code[HOOK_MAX_PATCH];
+};
+
+// Every patched address, with the bytes the patch replaced so that it can be undone.
+struct hook_record {
+    uintptr_t addr;
+    size_t    size;
+    bool      patched; // code is what is at addr now
+    bool      written; // code has been applied at least once
+    uint8_t   backup[HOOK_MAX_PATCH];
+    uint8_t   code[HOOK_MAX_PATCH];
+};
+
+static hook_chunk      *__chunks      = NULL;
+static pthread_mutex_t  __chunks_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static hook_patch      *__batch       = NULL;
+static size_t           __batch_count = 0;
+static size_t           __batch_cap   = 0;
+static unsigned         __batch_depth = 0;
+static timespec         __batch_start;
+static pthread_mutex_t  __batch_lock  = PTHREAD_MUTEX_INITIALIZER;
+
+static hook_record     *__records      = NULL;
+static size_t           __record_count = 0;
+static size_t           __record_cap   = 0;
+
+//-------------------------------------------------------------------------
+
+static inline uintptr_t __distance(uintptr_t a, uintptr_t b) {
+    return a > b ? a - b : b - a;
+}
+
+static inline bool __in_range(uintptr_t p, size_t n, uintptr_t target, uintptr_t range) {
+    return __distance(p, target) <= range && __distance(p + n, target) <= range;
+}
+
+// Scan /proc/self/maps for the unmapped, page-aligned address closest to `target`
+// that can hold `size` bytes without leaving [target - range, target + range].
+static uintptr_t __find_near_gap(uintptr_t target, size_t size, uintptr_t range) {
+    FILE *fp = fopen("/proc/self/maps", "re");
+    if (fp == NULL) {
+        HOOK_LOGE("failed to open /proc/self/maps");
+        return 0;
+    } //if
+
+    const uintptr_t window_lo = target > range + HOOK_MIN_ADDR ? target - range : HOOK_MIN_ADDR;
+    const uintptr_t window_hi = UINTPTR_MAX - target > range ? target + range : UINTPTR_MAX;
+
+    uintptr_t best = 0, best_dist = UINTPTR_MAX, prev_end = HOOK_MIN_ADDR;
+    char      line[512];
+    for (bool last = false; !last;) {
+        uintptr_t start, end;
+        if (fgets(line, sizeof(line), fp) == NULL) {
+            // the gap above the last mapping
+            last  = true;
+            start = window_hi;
+            end   = window_hi;
+        } else if (sscanf(line, "%" SCNxPTR "-%" SCNxPTR, &start, &end) != 2) {
+            continue;
+        } //if
+
+        uintptr_t lo = __align_up(prev_end > window_lo ? prev_end : window_lo, HOOK_PAGE_SIZE);
+        uintptr_t hi = start < window_hi ? start : window_hi;
+        if (hi > lo && hi - lo >= size) {
+            hi = __align_down(hi - size, HOOK_PAGE_SIZE);
+            uintptr_t candidate = __align_down(target, HOOK_PAGE_SIZE);
+            candidate = candidate < lo ? lo : candidate > hi ? hi : candidate;
+            if (__distance(candidate, target) < best_dist) {
+                best      = candidate;
+                best_dist = __distance(candidate, target);
+            } //if
+        } //if
+
+        if (end > prev_end) prev_end = end;
+    }
+    fclose(fp);
+    return best;
+}
+
+// Map `size` bytes of trampoline pages, at `hint` if it is not 0.
+// The pages are backed by a memfd and mapped twice: an R-X view that is executed and a RW- view
+// that is written to, so no page is ever writable and executable at once. If memfd mappings
+// are not permitted, a single RWX anonymous mapping is used instead.
+static hook_chunk *__map_chunk_at(uintptr_t hint, size_t size) {
+    int flags = 0;
+#ifdef MAP_FIXED_NOREPLACE
+    if (hint != 0) flags |= MAP_FIXED_NOREPLACE;
+#endif // MAP_FIXED_NOREPLACE
+
+    void *x = MAP_FAILED, *w = MAP_FAILED;
+    int   fd = memfd_create("hook_trampolines", MFD_CLOEXEC);
+    if (fd >= 0) {
+        if (ftruncate(fd, static_cast<off_t>(size)) == 0) {
+            x = mmap(reinterpret_cast<void *>(hint), size, PROT_READ | PROT_EXEC, MAP_SHARED | flags, fd, 0);
+            if (x != MAP_FAILED) {
+                w = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if (w == MAP_FAILED) {
+                    munmap(x, size);
+                    x = MAP_FAILED;
+                } //if
+            } //if
+        } //if
+        close(fd);
+    } //if
+
+    if (x == MAP_FAILED) {
+        HOOK_LOGI("dual-mapped trampolines unavailable (errno = %d), falling back to RWX", errno);
+        x = mmap(reinterpret_cast<void *>(hint), size, PROT_READ | PROT_WRITE | PROT_EXEC,
+                 MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+        if (x == MAP_FAILED) {
+            HOOK_LOGE("mmap of %zu bytes failed", size);
+            return NULL;
+        } //if
+        w = x;
+    } //if
+
+    hook_chunk *chunk = static_cast<hook_chunk *>(malloc(sizeof(hook_chunk)));
+    if (chunk == NULL) {
+        if (w != x) munmap(w, size);
+        munmap(x, size);
+        return NULL;
+    } //if
+    chunk->base  = reinterpret_cast<uintptr_t>(x);
+    chunk->wbase = reinterpret_cast<uintptr_t>(w);
+    chunk->size  = size;
+    chunk->used  = 0;
+    chunk->next  = NULL;
+    return chunk;
+}
+
+static void __unmap_chunk(hook_chunk *chunk) {
+    if (chunk->wbase != chunk->base) munmap(reinterpret_cast<void *>(chunk->wbase), chunk->size);
+    munmap(reinterpret_cast<void *>(chunk->base), chunk->size);
+    free(chunk);
+}
+
+static hook_chunk *__link_chunk(hook_chunk *chunk) {
+    chunk->next = __chunks;
+    __chunks    = chunk;
+    return chunk;
+}
+
+static hook_chunk *__map_chunk(size_t size) {
+    size = __align_up(size, HOOK_CHUNK_SIZE);
+
+    hook_chunk *chunk = __map_chunk_at(0, size);
+    if (chunk == NULL) return NULL;
+
+    HOOK_LOGI("mapped trampoline chunk %#" PRIxPTR " (%zu bytes)", chunk->base, size);
+    return __link_chunk(chunk);
+}
+
+static hook_chunk *__map_chunk_near(uintptr_t target, size_t size, uintptr_t range) {
+    size = __align_up(size, HOOK_CHUNK_SIZE);
+
+    uintptr_t hint = __find_near_gap(target, size, range);
+    if (hint == 0) {
+        HOOK_LOGE("no free gap within %#" PRIxPTR " bytes of %#" PRIxPTR, range, target);
+        return NULL;
+    } //if
+
+    hook_chunk *chunk = __map_chunk_at(hint, size);
+    if (chunk == NULL) return NULL;
+    if (!__in_range(chunk->base, size, target, range)) {
+        // older kernels treat the address as a hint only, and someone raced us for the gap
+        HOOK_LOGE("mmap near %#" PRIxPTR " returned %#" PRIxPTR " out of range", hint, chunk->base);
+        __unmap_chunk(chunk);
+        return NULL;
+    } //if
+
+    HOOK_LOGI("mapped trampoline chunk %#" PRIxPTR " (%zu bytes) near %#" PRIxPTR, chunk->base, size, target);
+    return __link_chunk(chunk);
+}
+
+static hook_chunk *__find_chunk(uintptr_t addr) {
+    for (hook_chunk *chunk = __chunks; chunk != NULL; chunk = chunk->next) {
+        if (addr >= chunk->base && addr < chunk->base + chunk->size) return chunk;
+    }
+    return NULL;
+}
+
+static void *__allocate(uintptr_t target, size_t size, uintptr_t range) {
+    size = __align_up(size, HOOK_ALIGN);
+
+    pthread_mutex_lock(&__chunks_lock);
+    hook_chunk *chunk = __chunks;
+    for (; chunk != NULL; chunk = chunk->next) {
+        if (chunk->size - chunk->used >= size
+            && (range == UINTPTR_MAX || __in_range(chunk->base + chunk->used, size, target, range))) {
+            break;
+        } //if
+    }
+    if (chunk == NULL) {
+        chunk = range == UINTPTR_MAX ? __map_chunk(size) : __map_chunk_near(target, size, range);
+    } //if
+
+    void *p = NULL;
+    if (chunk != NULL) {
+        p            = reinterpret_cast<void *>(chunk->base + chunk->used);
+        chunk->used += size;
+    } //if
+    pthread_mutex_unlock(&__chunks_lock);
+    return p;
+}
+
+//-------------------------------------------------------------------------
+
+void *HookAllocate(size_t size) {
+    return __allocate(0, size, UINTPTR_MAX);
+}
+
+void *HookAllocateNear(const void *target, size_t size, uintptr_t range) {
+    return __allocate(reinterpret_cast<uintptr_t>(target), size, range);
+}
+
+void HookShrink(void *p, size_t reserved, size_t used) {
+    const uintptr_t addr = reinterpret_cast<uintptr_t>(p);
+    reserved = __align_up(reserved, HOOK_ALIGN);
+    used     = __align_up(used, HOOK_ALIGN);
+    if (p == NULL || used >= reserved) return;
+
+    pthread_mutex_lock(&__chunks_lock);
+    hook_chunk *chunk = __find_chunk(addr);
+    if (chunk != NULL && addr + reserved == chunk->base + chunk->used) {
+        chunk->used -= reserved - used;
+    } //if
+    pthread_mutex_unlock(&__chunks_lock);
+}
+
+void *HookWritable(const void *p) {
+    const uintptr_t addr = reinterpret_cast<uintptr_t>(p);
+
+    pthread_mutex_lock(&__chunks_lock);
+    hook_chunk *chunk = __find_chunk(addr);
+    uintptr_t   w     = chunk != NULL ? addr - chunk->base + chunk->wbase : addr;
+    pthread_mutex_unlock(&__chunks_lock);
+    return reinterpret_cast<void *>(w);
+}
+
+void HookGetUsage(size_t *mapped, size_t *used) {
+    size_t m = 0, u = 0;
+    pthread_mutex_lock(&__chunks_lock);
+    for (hook_chunk *chunk = __chunks; chunk != NULL; chunk = chunk->next) {
+        m += chunk->size;
+        u += chunk->used;
+    }
+    pthread_mutex_unlock(&__chunks_lock);
+    if (mapped != NULL) *mapped = m;
+    if (used != NULL) *used = u;
+}
+
+//-------------------------------------------------------------------------
+
+// Whether `size` bytes at `addr` lie within one aligned 8 byte word, which __write_patch stores at once.
+static bool __fits_word(uintptr_t addr, size_t size) {
+    return (addr & 7) + size <= sizeof(uint64_t);
+}
+
+static void __write_patch(const hook_patch *patch) {
+    void *dst = reinterpret_cast<void *>(patch->addr);
+    if (patch->size == sizeof(uint32_t) && (patch->addr & 3) == 0) {
+        uint32_t v;
+        memcpy(&v, patch->code, sizeof(v));
+        __atomic_store_n(static_cast<uint32_t *>(dst), v, __ATOMIC_SEQ_CST);
+    } else if (patch->size == sizeof(uint64_t) && (patch->addr & 7) == 0) {
+        uint64_t v;
+        memcpy(&v, patch->code, sizeof(v));
+        __atomic_store_n(static_cast<uint64_t *>(dst), v, __ATOMIC_SEQ_CST);
+    } else if (__fits_word(patch->addr, patch->size)) {
+        // the patch lies within one aligned word, splice it in and store the whole word at once
+        uint64_t *word = reinterpret_cast<uint64_t *>(patch->addr & ~static_cast<uintptr_t>(7));
+        uint64_t  v    = __atomic_load_n(word, __ATOMIC_RELAXED);
+        memcpy(reinterpret_cast<uint8_t *>(&v) + (patch->addr & 7), patch->code, patch->size);
+        __atomic_store_n(word, v, __ATOMIC_SEQ_CST);
+    } else {
+        memcpy(dst, patch->code, patch->size);
+    } //if
+}
+
+// Applies `count` patches sorted by address, grouping the ones whose pages touch.
+// Marks each patch that was written as applied and returns their number.
+static int __apply_patches(hook_patch *patches, size_t count) {
+    int applied = 0;
+    for (size_t i = 0, j; i < count; i = j) {
+        uintptr_t lo = __align_down(patches[i].addr, HOOK_PAGE_SIZE);
+        uintptr_t hi = __align_up(patches[i].addr + patches[i].size, HOOK_PAGE_SIZE);
+        for (j = i + 1; j < count && __align_down(patches[j].addr, HOOK_PAGE_SIZE) <= hi; ++j) {
+            uintptr_t end = __align_up(patches[j].addr + patches[j].size, HOOK_PAGE_SIZE);
+            if (end > hi) hi = end;
+        }
+
+        if (mprotect(reinterpret_cast<void *>(lo), hi - lo, PROT_READ | PROT_WRITE | PROT_EXEC) != 0) {
+            HOOK_LOGE("mprotect failed with errno = %d, p = %#" PRIxPTR ", size = %zu", errno, lo, hi - lo);
+            for (size_t k = i; k < j; ++k) {
+                patches[k].applied = false;
+            }
+            continue;
+        } //if
+        for (size_t k = i; k < j; ++k) {
+            __write_patch(&patches[k]);
+            patches[k].applied = true;
+        }
+        for (size_t k = i; k < j; ++k) {
+            char *p = reinterpret_cast<char *>(patches[k].addr);
+            __builtin___clear_cache(p, p + patches[k].size);
+        }
+        if (mprotect(reinterpret_cast<void *>(lo), hi - lo, PROT_READ | PROT_EXEC) != 0) {
+            // the patches are in place, but the pages stay writable and executable
+            HOOK_LOGE("restoring R-X failed with errno = %d, p = %#" PRIxPTR ", size = %zu", errno, lo, hi - lo);
+        } //if
+        applied += static_cast<int>(j - i);
+    }
+    return applied;
+}
+
+static int __compare_patches(const void *a, const void *b) {
+    uintptr_t x = static_cast<const hook_patch *>(a)->addr, y = static_cast<const hook_patch *>(b)->addr;
+    return x < y ? -1 : x > y ? 1 : 0;
+}
+
+static hook_record *__find_record(uintptr_t addr) {
+    for (size_t i = 0; i < __record_count; ++i) {
+        if (__records[i].addr == addr) return &__records[i];
+    }
+    return NULL;
+}
+
+// Remembers the bytes under `patch` the first time an address is patched. The record only takes the
+// code of the patch once it has been applied, see __patch_done(). Called with __batch_lock held.
+static bool __record_patch(const hook_patch *patch) {
+    hook_record *record = __find_record(patch->addr);
+    if (record == NULL) {
+        if (__record_count == __record_cap) {
+            size_t       cap = __record_cap != 0 ? __record_cap * 2 : 16;
+            hook_record *p   = static_cast<hook_record *>(realloc(__records, cap * sizeof(hook_record)));
+            if (p == NULL) return false;
+            __records    = p;
+            __record_cap = cap;
+        } //if
+        record          = &__records[__record_count++];
+        record->addr    = patch->addr;
+        record->size    = patch->size;
+        record->patched = false;
+        record->written = false;
+        memcpy(record->backup, reinterpret_cast<const void *>(patch->addr), patch->size);
+    } else if (record->size != patch->size) {
+        HOOK_LOGE("patch at %#" PRIxPTR " changed size from %zu to %zu", patch->addr, record->size, patch->size);
+        return false;
+    } //if
+    return true;
+}
+
+// Updates the record of a patch passed to __apply_patches. Called with __batch_lock held.
+static bool __patch_done(const hook_patch *patch) {
+    if (!patch->applied) {
+        HOOK_LOGE("patch at %#" PRIxPTR " was not applied", patch->addr);
+        return false;
+    } //if
+    hook_record *record = __find_record(patch->addr);
+    record->patched     = true;
+    record->written     = true;
+    memcpy(record->code, patch->code, patch->size);
+    return true;
+}
+
+bool HookPatchText(void *address, const void *code, size_t size) {
+    if (size > HOOK_MAX_PATCH) {
+        HOOK_LOGE("patch of %zu bytes at %p is too large", size, address);
+        return false;
+    } //if
+
+    hook_patch patch;
+    patch.addr    = reinterpret_cast<uintptr_t>(address);
+    patch.size    = size;
+    patch.applied = false;
+    memcpy(patch.code, code, size);
+
+    pthread_mutex_lock(&__batch_lock);
+    if (!__record_patch(&patch)) {
+        pthread_mutex_unlock(&__batch_lock);
+        return false;
+    } //if
+    if (__batch_depth == 0) {
+        __apply_patches(&patch, 1);
+        bool ok = __patch_done(&patch);
+        pthread_mutex_unlock(&__batch_lock);
+        return ok;
+    } //if
+
+    if (__batch_count == __batch_cap) {
+        size_t      cap = __batch_cap != 0 ? __batch_cap * 2 : 16;
+        hook_patch *p   = static_cast<hook_patch *>(realloc(__batch, cap * sizeof(hook_patch)));
+        if (p == NULL) {
+            pthread_mutex_unlock(&__batch_lock);
+            return false;
+        } //if
+        __batch     = p;
+        __batch_cap = cap;
+    } //if
+    __batch[__batch_count++] = patch;
+    pthread_mutex_unlock(&__batch_lock);
+    return true;
+}
+
+void HookBatchBegin() {
+    pthread_mutex_lock(&__batch_lock);
+    if (__batch_depth++ == 0) {
+        __batch_count = 0;
+        clock_gettime(CLOCK_MONOTONIC, &__batch_start);
+    } //if
+    pthread_mutex_unlock(&__batch_lock);
+}
+
+bool HookBatchIsOpen() {
+    pthread_mutex_lock(&__batch_lock);
+    bool open = __batch_depth != 0;
+    pthread_mutex_unlock(&__batch_lock);
+    return open;
+}
+
+int HookBatchCommit(uint64_t *elapsed_ns) {
+    pthread_mutex_lock(&__batch_lock);
+    if (elapsed_ns != NULL) *elapsed_ns = 0;
+    if (__batch_depth == 0) {
+        pthread_mutex_unlock(&__batch_lock);
+        HOOK_LOGE("commit without an open batch");
+        return 0;
+    } //if
+    if (--__batch_depth != 0) {
+        // an inner batch, its patches are applied with the outermost one
+        pthread_mutex_unlock(&__batch_lock);
+        return 0;
+    } //if
+
+    int applied = 0;
+    if (__batch_count != 0) {
+        qsort(__batch, __batch_count, sizeof(hook_patch), __compare_patches);
+        __apply_patches(__batch, __batch_count);
+        for (size_t i = 0; i < __batch_count; ++i) {
+            if (!__patch_done(&__batch[i])) continue;
+            HOOK_LOGI("queued patch at %#" PRIxPTR " applied successfully! %zu bytes overwritten",
+                      __batch[i].addr, __batch[i].size);
+            ++applied;
+        }
+    } //if
+
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    uint64_t elapsed = static_cast<uint64_t>(now.tv_sec - __batch_start.tv_sec) * 1000000000ull
+                       + now.tv_nsec - __batch_start.tv_nsec;
+    if (elapsed_ns != NULL) *elapsed_ns = elapsed;
+    HOOK_LOGI("committed %d/%zu patches in %" PRIu64 " ns", applied, __batch_count, elapsed);
+
+    free(__batch);
+    __batch       = NULL;
+    __batch_count = 0;
+    __batch_cap   = 0;
+    pthread_mutex_unlock(&__batch_lock);
+    return applied;
+}
+
+void HookBatchAbort() {
+    pthread_mutex_lock(&__batch_lock);
+    if (__batch_depth != 0) HOOK_LOGI("dropped %zu queued patches", __batch_count);
+    free(__batch);
+    __batch       = NULL;
+    __batch_count = 0;
+    __batch_cap   = 0;
+    __batch_depth = 0;
+    pthread_mutex_unlock(&__batch_lock);
+}
+
+bool HookSetPatched(void *address, bool patched) {
+    pthread_mutex_lock(&__batch_lock);
+    hook_record *record = __find_record(reinterpret_cast<uintptr_t>(address));
+    if (record == NULL) {
+        pthread_mutex_unlock(&__batch_lock);
+        HOOK_LOGE("%p has not been patched", address);
+        return false;
+    } //if
+
+    bool ok = true;
+    if (patched && !record->written) {
+        HOOK_LOGE("the patch at %p has never been applied", address);
+        ok = false;
+    } else if (record->patched != patched) {
+        hook_patch patch;
+        patch.addr = record->addr;
+        patch.size = record->size;
+        memcpy(patch.code, patched ? record->code : record->backup, record->size);
+        ok = __apply_patches(&patch, 1) == 1;
+        if (ok) record->patched = patched;
+    } //if
+    pthread_mutex_unlock(&__batch_lock);
+    return ok;
+}
+
+bool HookIsPatched(const void *address) {
+    pthread_mutex_lock(&__batch_lock);
+    hook_record *record  = __find_record(reinterpret_cast<uintptr_t>(address));
+    bool         patched = record != NULL && record->patched;
+    pthread_mutex_unlock(&__batch_lock);
+    return patched;
+}
+
+bool HookIsAtomic(const void *address) {
+    pthread_mutex_lock(&__batch_lock);
+    hook_record *record = __find_record(reinterpret_cast<uintptr_t>(address));
+    bool         atomic = record != NULL && __fits_word(record->addr, record->size);
+    pthread_mutex_unlock(&__batch_lock);
+    return atomic;
+}
+
+//-------------------------------------------------------------------------
+
+void A64HookBegin() {
+    HookBatchBegin();
+}
+
+int A64HookCommit(uint64_t *elapsed_ns) {
+    return HookBatchCommit(elapsed_ns);
+}
+
+void A64HookAbort() {
+    HookBatchAbort();
+}
+
+bool A64UnhookFunction(void *const symbol) {
+    if (!HookIsAtomic(symbol)) {
+        HOOK_LOGE("the patch at %p is not one aligned word and cannot be removed while the function may run", symbol);
+        return false;
+    } //if
+    return HookSetPatched(symbol, false);
+}
+
+bool A64RehookFunction(void *const symbol) {
+    if (!HookIsAtomic(symbol)) {
+        HOOK_LOGE("the patch at %p is not one aligned word and cannot be written while the function may run", symbol);
+        return false;
+    } //if
+    return HookSetPatched(symbol, true);
+}
+
+bool A64IsHooked(void *const symbol) {
+    return HookIsPatched(symbol);
+}
+
+void A64GetTrampolineUsage(uintptr_t *mapped, uintptr_t *used) {
+    size_t m = 0, u = 0;
+    HookGetUsage(&m, &u);
+    if (mapped != NULL) *mapped = m;
+    if (used != NULL) *used = u;
+}
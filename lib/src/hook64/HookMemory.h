@@ -0,0 +1,77 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Executable memory for trampolines.
+ *
+ * The arena starts empty and grows one chunk of pages at a time. Chunks for near
+ * allocations are mapped inside the free gaps of /proc/self/maps, so that a trampoline
+ * can be placed close enough to the code it belongs to for a single pc-relative branch
+ * to reach it. Allocations are bump-allocated and can give back the unused tail of a
+ * worst-case reservation once the real size of the relocated code is known.
+ *
+ * Where the kernel allows it, chunks are W^X: code is executed from an R-X view and
+ * written through a separate RW- view of the same memfd, see HookWritable().
+ */
+
+// Returns `size` bytes of executable memory anywhere in the address space, or NULL.
+// The returned pointer is 16-byte aligned.
+void *HookAllocate(size_t size);
+
+// Returns `size` bytes of executable memory that lie entirely within `range` bytes of `target`,
+// or NULL if no gap near `target` could be mapped. The returned pointer is 16-byte aligned.
+void *HookAllocateNear(const void *target, size_t size, uintptr_t range);
+
+// Shrinks the most recent allocation `p` of `reserved` bytes down to `used` bytes.
+// Does nothing if another allocation has been made from the same chunk since.
+void HookShrink(void *p, size_t reserved, size_t used);
+
+// Returns the writable alias of the arena address `p`, or `p` itself if it is not arena memory.
+void *HookWritable(const void *p);
+
+// Bytes of address space mapped for the arena, and bytes handed out from it.
+void HookGetUsage(size_t *mapped, size_t *used);
+
+/*
+ * Patching of code pages.
+ *
+ * Patched pages are made writable only for the duration of the write and are left R-X.
+ * Between HookBatchBegin() and HookBatchCommit() patches are queued instead, and the commit
+ * applies them grouped by page: one mprotect pair per run of neighbouring pages and one
+ * cache flush per patched range, however many hooks share a page. Batches nest: only the
+ * commit matching the outermost HookBatchBegin() applies the queued patches.
+ */
+
+#define HOOK_MAX_PATCH 32
+
+// Writes `size` bytes of `code` over `address`, or queues the write if a batch is open.
+// A patch that fits within one aligned 8 byte word is written with a single atomic store.
+// The bytes it replaces are kept, see HookSetPatched().
+bool HookPatchText(void *address, const void *code, size_t size);
+
+// Puts back the original bytes under the last patch written at `address` (patched = false),
+// or writes the patch again (patched = true). Always applied immediately, even in a batch.
+bool HookSetPatched(void *address, bool patched);
+
+// Whether the last patch at `address` has been applied and not been undone.
+bool HookIsPatched(const void *address);
+
+// Whether the last patch at `address` fits within one aligned 8 byte word, so that HookSetPatched()
+// swaps it with a single atomic store and a thread running the code sees either all of it or none.
+bool HookIsAtomic(const void *address);
+
+void HookBatchBegin();
+
+// Whether HookPatchText() queues patches instead of applying them.
+bool HookBatchIsOpen();
+
+// Closes the innermost batch. Closing the outermost one applies the queued patches and returns the
+// number of patches applied, and the time since its HookBatchBegin() in `elapsed_ns` if it is not NULL;
+// an inner batch applies nothing and returns 0. A patch that could not be applied is logged with its
+// address and left unpatched, see HookIsPatched().
+int HookBatchCommit(uint64_t *elapsed_ns);
+
+// Drops the queued patches and closes the batch, with every batch nested in it. Nothing is written.
+void HookBatchAbort();
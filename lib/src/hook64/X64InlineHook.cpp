@@ -0,0 +1,477 @@
+/*
+ * x86-64 backend of the A64HookFunction API, so the hook macros can run on Linux build hosts.
+ *
+ * The target is patched with a 5-byte "JMP rel32" when the replacement is within 2 GB. A farther
+ * replacement is reached through an entry island mapped within 2 GB of the target, which holds the
+ * 14-byte "JMP [RIP+0]; .quad"; only if there is no room for one is that jump written over the
+ * target itself. Whole instructions covering the patch are
+ * copied into a trampoline mapped next to the target where possible, with rip-relative
+ * operands and relative branches rewritten for their new address.
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__)
+
+#include "hook64/And64InlineHook.hpp"
+#include "HookLog.h"
+#include "HookMemory.h"
+
+#define   X64_JMP_REL32_SIZE   5
+#define   X64_JMP_ABS_SIZE     14
+#define   X64_MAX_INSN_SIZE    15
+#define   X64_TRAMPOLINE_SIZE  256u
+#define   X64_ISLAND_SIZE      16u // X64_JMP_ABS_SIZE, rounded up to the arena's alignment
+#define   X64_NEAR_RANGE       (0x7fffffffu - 0x100000u) // reach of rel32, minus some slack
+#define   X64_INT3             0xccu
+
+//-------------------------------------------------------------------------
+
+struct x64_insn {
+    uint8_t len;
+    uint8_t map;      // 0: one-byte, 1: 0F, 2: 0F 38, 3: 0F 3A
+    uint8_t opcode;
+    uint8_t op_off;   // offset of the opcode byte
+    int8_t  disp_off; // offset of a rip-relative disp32, or -1
+    int8_t  rel_off;  // offset of a relative branch displacement, or -1
+    uint8_t rel_size;
+};
+
+static inline bool __fits_rel32(int64_t v) {
+    return v >= INT32_MIN && v <= INT32_MAX;
+}
+
+// Length decoder for the general purpose, SSE and VEX encoded instructions found in prologues.
+static bool __x64_decode(const uint8_t *code, x64_insn *insn) {
+    const uint8_t *p        = code;
+    bool           opsize16 = false, addr32 = false, rex_w = false;
+
+    memset(insn, 0, sizeof(*insn));
+    insn->disp_off = -1;
+    insn->rel_off  = -1;
+
+    for (;; ++p) {
+        const uint8_t b = *p;
+        if (b == 0x66) {
+            opsize16 = true;
+        } else if (b == 0x67) {
+            addr32 = true;
+        } else if (b != 0xf0 && b != 0xf2 && b != 0xf3 && b != 0x26 && b != 0x2e && b != 0x36 && b != 0x3e
+                   && b != 0x64 && b != 0x65) {
+            break;
+        } //if
+        if (p - code >= X64_MAX_INSN_SIZE) return false;
+    }
+    if ((*p & 0xf0u) == 0x40u) {
+        rex_w = (*p & 0x08u) != 0;
+        ++p;
+    } //if
+
+    const int z      = opsize16 ? 2 : 4;
+    bool      modrm  = false;
+    bool      group3 = false; // F6/F7: immediate only for TEST
+    int       imm    = 0;
+    uint8_t   map    = 0;
+    uint8_t   op     = *p;
+
+    if (op == 0xc4 || op == 0xc5) {
+        // VEX, C4/C5 are never LES/LDS in 64-bit mode
+        if (op == 0xc5) {
+            map = 1;
+            p += 2;
+        } else {
+            map = p[1] & 0x1fu;
+            p += 3;
+            if (map < 1 || map > 3) return false;
+        } //if
+        insn->op_off = static_cast<uint8_t>(p - code);
+        op           = *p++;
+        modrm        = !(map == 1 && op == 0x77); // vzeroupper/vzeroall
+        if (map == 3 || (map == 1 && ((op >= 0x70 && op <= 0x73) || (op >= 0xc4 && op <= 0xc6) || op == 0xc2))) {
+            imm = 1;
+        } //if
+    } else if (op == 0x0f) {
+        ++p;
+        if (*p == 0x38 || *p == 0x3a) {
+            map = *p == 0x38 ? 2 : 3;
+            ++p;
+            modrm = true;
+            imm   = map == 3 ? 1 : 0;
+        } else {
+            map = 1;
+        } //if
+        insn->op_off = static_cast<uint8_t>(p - code);
+        op           = *p++;
+        if (map == 1) {
+            if (op >= 0x80 && op <= 0x8f) {
+                insn->rel_size = 4; // Jcc rel32
+            } else if ((op >= 0x05 && op <= 0x09) || op == 0x0b || op == 0x0e || (op >= 0x30 && op <= 0x37)
+                       || op == 0x77 || (op >= 0xa0 && op <= 0xa2) || (op >= 0xa8 && op <= 0xaa)
+                       || (op >= 0xc8 && op <= 0xcf)) {
+                modrm = false;
+            } else {
+                modrm = true;
+                if ((op >= 0x70 && op <= 0x73) || op == 0xa4 || op == 0xac || op == 0xba || op == 0xc2
+                    || (op >= 0xc4 && op <= 0xc6) || op == 0x0f) {
+                    imm = 1;
+                } //if
+            } //if
+        } //if
+    } else {
+        insn->op_off = static_cast<uint8_t>(p - code);
+        ++p;
+        if (op < 0x40) {
+            switch (op & 7u) {
+                case 0: case 1: case 2: case 3: modrm = true; break;
+                case 4: imm = 1; break;
+                case 5: imm = z; break;
+                default: return false; // segment push/pop and BCD ops are invalid in 64-bit mode
+            }
+        } else if (op >= 0x50 && op <= 0x5f) {
+        } else if (op == 0x63) {
+            modrm = true;
+        } else if (op == 0x68) {
+            imm = z;
+        } else if (op == 0x69) {
+            modrm = true;
+            imm   = z;
+        } else if (op == 0x6a) {
+            imm = 1;
+        } else if (op == 0x6b) {
+            modrm = true;
+            imm   = 1;
+        } else if (op >= 0x6c && op <= 0x6f) {
+        } else if (op >= 0x70 && op <= 0x7f) {
+            insn->rel_size = 1; // Jcc rel8
+        } else if (op == 0x80 || op == 0x83 || op == 0xc0 || op == 0xc1 || op == 0xc6) {
+            modrm = true;
+            imm   = 1;
+        } else if (op == 0x81 || op == 0xc7) {
+            modrm = true;
+            imm   = z;
+        } else if (op >= 0x84 && op <= 0x8f) {
+            modrm = true;
+        } else if ((op >= 0x90 && op <= 0x99) || (op >= 0x9b && op <= 0x9f)) {
+        } else if (op >= 0xa0 && op <= 0xa3) {
+            imm = addr32 ? 4 : 8; // moffs
+        } else if ((op >= 0xa4 && op <= 0xa7) || (op >= 0xaa && op <= 0xaf)) {
+        } else if (op == 0xa8 || (op >= 0xb0 && op <= 0xb7) || op == 0xcd || (op >= 0xe4 && op <= 0xe7)) {
+            imm = 1;
+        } else if (op == 0xa9) {
+            imm = z;
+        } else if (op >= 0xb8 && op <= 0xbf) {
+            imm = rex_w ? 8 : z;
+        } else if (op == 0xc2 || op == 0xca) {
+            imm = 2;
+        } else if (op == 0xc8) {
+            imm = 3;
+        } else if (op == 0xc3 || op == 0xc9 || op == 0xcb || op == 0xcc || op == 0xcf || op == 0xd7
+                   || (op >= 0xec && op <= 0xef) || op == 0xf1 || op == 0xf4 || op == 0xf5
+                   || (op >= 0xf8 && op <= 0xfd)) {
+        } else if ((op >= 0xd0 && op <= 0xd3) || (op >= 0xd8 && op <= 0xdf) || op == 0xfe || op == 0xff) {
+            modrm = true;
+        } else if (op == 0xf6 || op == 0xf7) {
+            modrm  = true;
+            group3 = true;
+        } else if ((op >= 0xe0 && op <= 0xe3) || op == 0xeb) {
+            insn->rel_size = 1; // LOOPcc / JrCXZ / JMP rel8
+        } else if (op == 0xe8 || op == 0xe9) {
+            insn->rel_size = 4; // CALL / JMP rel32
+        } else {
+            return false;
+        } //if
+    } //if
+
+    if (modrm) {
+        const uint8_t m = *p++, mod = m >> 6, rm = m & 7u;
+        if (mod != 3) {
+            if (rm == 4) {
+                const uint8_t sib = *p++;
+                if (mod == 0 && (sib & 7u) == 5) p += 4;
+            } else if (mod == 0 && rm == 5) {
+                if (addr32) return false; // eip-relative, never emitted by compilers
+                insn->disp_off = static_cast<int8_t>(p - code);
+                p += 4;
+            } //if
+            if (mod == 1) p += 1;
+            if (mod == 2) p += 4;
+        } //if
+        if (group3 && ((m >> 3) & 7u) < 2) imm = op == 0xf6 ? 1 : z;
+    } //if
+
+    if (insn->rel_size != 0) {
+        insn->rel_off = static_cast<int8_t>(p - code);
+        p += insn->rel_size;
+    } //if
+    p += imm;
+
+    if (p - code > X64_MAX_INSN_SIZE) return false;
+    insn->len    = static_cast<uint8_t>(p - code);
+    insn->map    = map;
+    insn->opcode = op;
+    return true;
+}
+
+// Number of bytes taken by the whole instructions covering the first `min_len` bytes of `code`.
+static size_t __x64_prologue_length(const uint8_t *code, size_t min_len) {
+    size_t total = 0;
+    while (total < min_len) {
+        x64_insn insn;
+        if (!__x64_decode(code + total, &insn)) {
+            HOOK_LOGE("unknown instruction at %p", code + total);
+            return 0;
+        } //if
+        total += insn.len;
+    }
+    return total;
+}
+
+//-------------------------------------------------------------------------
+
+struct x64_writer {
+    uint8_t  *buf; // where the code is assembled
+    uintptr_t pc;  // where buf[0] will execute
+    size_t    len;
+    size_t    cap;
+
+    inline bool put(const void *p, size_t n) {
+        if (len + n > cap) return false;
+        memcpy(buf + len, p, n);
+        len += n;
+        return true;
+    }
+
+    inline bool put8(uint8_t b) {
+        return put(&b, 1);
+    }
+
+    inline bool put32(int32_t v) {
+        return put(&v, sizeof(v));
+    }
+
+    inline bool put64(uint64_t v) {
+        return put(&v, sizeof(v));
+    }
+
+    inline int64_t next(size_t insn_len) const {
+        return static_cast<int64_t>(pc + len + insn_len);
+    }
+
+    bool jmp(uintptr_t target) {
+        int64_t rel = static_cast<int64_t>(target) - next(X64_JMP_REL32_SIZE);
+        if (__fits_rel32(rel)) {
+            return put8(0xe9) && put32(static_cast<int32_t>(rel)); // JMP rel32
+        } //if
+        // JMP [RIP+0]; .quad target
+        return put8(0xff) && put8(0x25) && put32(0) && put64(target);
+    }
+
+    bool call(uintptr_t target) {
+        int64_t rel = static_cast<int64_t>(target) - next(5);
+        if (__fits_rel32(rel)) {
+            return put8(0xe8) && put32(static_cast<int32_t>(rel)); // CALL rel32
+        } //if
+        // CALL [RIP+2]; JMP +8; .quad target
+        return put8(0xff) && put8(0x15) && put32(2) && put8(0xeb) && put8(0x08) && put64(target);
+    }
+
+    bool jcc(uint8_t cond, uintptr_t target) {
+        int64_t rel = static_cast<int64_t>(target) - next(6);
+        if (__fits_rel32(rel)) {
+            return put8(0x0f) && put8(0x80 | cond) && put32(static_cast<int32_t>(rel)); // Jcc rel32
+        } //if
+        // J!cc +14; JMP [RIP+0]; .quad target
+        return put8(0x70 | (cond ^ 1u)) && put8(X64_JMP_ABS_SIZE) && put8(0xff) && put8(0x25) && put32(0)
+               && put64(target);
+    }
+};
+
+// Copies the instructions covering the first `min_len` bytes of `src` to `w`, fixing every
+// pc-relative operand, and appends a jump back to the rest of the function.
+// Returns the number of source bytes relocated, or 0 if the prologue cannot be moved.
+static size_t __x64_relocate(const uint8_t *src, size_t min_len, x64_writer *w) {
+    const size_t    total = __x64_prologue_length(src, min_len);
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(src), end = begin + total;
+    if (total == 0) return 0;
+
+    for (size_t off = 0; off < total;) {
+        x64_insn insn;
+        __x64_decode(src + off, &insn);
+        const uint8_t  *ip   = src + off;
+        const uintptr_t next = begin + off + insn.len;
+
+        bool ok;
+        if (insn.rel_size != 0) {
+            int64_t rel;
+            if (insn.rel_size == 1) {
+                rel = static_cast<int8_t>(ip[insn.rel_off]);
+            } else {
+                int32_t r32;
+                memcpy(&r32, ip + insn.rel_off, sizeof(r32));
+                rel = r32;
+            } //if
+            const uintptr_t target = next + rel;
+            if (target > begin && target < end) {
+                HOOK_LOGE("branch at %p targets the relocated prologue", ip);
+                return 0;
+            } //if
+
+            if (insn.map == 0 && insn.opcode == 0xe8) {
+                ok = w->call(target);
+            } else if (insn.map == 0 && (insn.opcode == 0xe9 || insn.opcode == 0xeb)) {
+                ok = w->jmp(target);
+            } else if (insn.map == 0 && insn.opcode >= 0x70 && insn.opcode <= 0x7f) {
+                ok = w->jcc(insn.opcode & 0x0fu, target);
+            } else if (insn.map == 1 && insn.opcode >= 0x80 && insn.opcode <= 0x8f) {
+                ok = w->jcc(insn.opcode & 0x0fu, target);
+            } else {
+                HOOK_LOGE("cannot relocate LOOP/JrCXZ at %p", ip);
+                return 0;
+            } //if
+        } else if (insn.disp_off >= 0) {
+            int32_t disp;
+            memcpy(&disp, ip + insn.disp_off, sizeof(disp));
+            const int64_t target = static_cast<int64_t>(next) + disp;
+            const int64_t moved  = target - w->next(insn.len);
+            if (!__fits_rel32(moved)) {
+                HOOK_LOGE("rip-relative operand at %p is out of reach of the trampoline", ip);
+                return 0;
+            } //if
+            const size_t at = w->len;
+            ok              = w->put(ip, insn.len);
+            if (ok) {
+                disp = static_cast<int32_t>(moved);
+                memcpy(w->buf + at + insn.disp_off, &disp, sizeof(disp));
+            } //if
+        } else {
+            ok = w->put(ip, insn.len);
+        } //if
+
+        if (!ok) {
+            HOOK_LOGE("trampoline too small for the prologue of %p", src);
+            return 0;
+        } //if
+        off += insn.len;
+    }
+
+    if (!w->jmp(end)) {
+        HOOK_LOGE("trampoline too small for the prologue of %p", src);
+        return 0;
+    } //if
+    return total;
+}
+
+//-------------------------------------------------------------------------
+
+extern "C" {
+
+static void *__hook_function_v(void *const symbol, void *const replace,
+                               void *const rwx, const uintptr_t rwx_size, uintptr_t *used) {
+    uint8_t *const  original = static_cast<uint8_t *>(symbol);
+    const uintptr_t from     = reinterpret_cast<uintptr_t>(symbol);
+    const int64_t   rel      = static_cast<int64_t>(reinterpret_cast<uintptr_t>(replace) - from) - X64_JMP_REL32_SIZE;
+    const bool      near     = __fits_rel32(rel);
+    const size_t    min_len  = near ? X64_JMP_REL32_SIZE : X64_JMP_ABS_SIZE;
+
+    size_t total;
+    if (rwx != NULL) {
+        uint8_t    code[X64_TRAMPOLINE_SIZE];
+        x64_writer w = {code, reinterpret_cast<uintptr_t>(rwx), 0, rwx_size < sizeof(code) ? rwx_size : sizeof(code)};
+        total        = __x64_relocate(original, min_len, &w);
+        if (total == 0) return NULL;
+
+        memcpy(HookWritable(rwx), code, w.len);
+        __builtin___clear_cache(static_cast<char *>(rwx), static_cast<char *>(rwx) + w.len);
+        if (used != NULL) *used = w.len;
+    } else {
+        total = __x64_prologue_length(original, min_len);
+        if (total == 0) return NULL;
+    } //if
+
+    // Only the jump itself is written: the trampoline resumes after the last instruction it covers, so the
+    // bytes in between are never run, and a 5-byte jump at an aligned entry stays one atomic store.
+    uint8_t patch[HOOK_MAX_PATCH];
+    if (near) {
+        const int32_t rel32 = static_cast<int32_t>(rel);
+        patch[0]            = 0xe9; // JMP rel32
+        memcpy(patch + 1, &rel32, sizeof(rel32));
+    } else {
+        const uint64_t target = reinterpret_cast<uintptr_t>(replace);
+        patch[0]              = 0xff; // JMP [RIP+0]
+        patch[1]              = 0x25;
+        memset(patch + 2, 0, 4);
+        memcpy(patch + 6, &target, sizeof(target));
+    } //if
+
+    const bool queued = HookBatchIsOpen();
+    if (!HookPatchText(original, patch, min_len)) return NULL;
+    if (queued) {
+        HOOK_LOGI("inline hook %p->%p queued, %zu bytes to overwrite on commit", symbol, replace, min_len);
+    } else {
+        HOOK_LOGI("inline hook %p->%p successfully! %zu bytes overwritten", symbol, replace, min_len);
+    } //if
+    return rwx != NULL ? rwx : symbol;
+}
+
+void *A64HookFunctionV(void *const symbol, void *const replace, void *const rwx, const uintptr_t rwx_size) {
+    void *result = __hook_function_v(symbol, replace, rwx, rwx_size, NULL);
+    return rwx != NULL ? result : NULL;
+}
+
+//-------------------------------------------------------------------------
+
+// Maps an entry island within rel32 reach of `symbol` that jumps on to `replace`, so the entry can be
+// patched with a single "JMP rel32" however far away `replace` is. NULL if there is no free page near `symbol`.
+static void *__entry_island(void *const symbol, void *const replace) {
+    void *island = HookAllocateNear(symbol, X64_ISLAND_SIZE, X64_NEAR_RANGE);
+    if (island == NULL) return NULL;
+    uint8_t *const code   = static_cast<uint8_t *>(HookWritable(island));
+    const uint64_t target = reinterpret_cast<uintptr_t>(replace);
+    code[0]               = 0xff; // JMP [RIP+0]
+    code[1]               = 0x25;
+    memset(code + 2, 0, 4);
+    memcpy(code + 6, &target, sizeof(target));
+    memset(code + X64_JMP_ABS_SIZE, X64_INT3, X64_ISLAND_SIZE - X64_JMP_ABS_SIZE);
+    __builtin___clear_cache(static_cast<char *>(island), static_cast<char *>(island) + X64_ISLAND_SIZE);
+    return island;
+}
+
+//-------------------------------------------------------------------------
+
+void A64HookFunction(void *const symbol, void *const replace, void **result) {
+    // allocated before the trampoline, which can only give back its unused tail while it is the latest allocation
+    void *target = replace;
+    if (!__fits_rel32(static_cast<int64_t>(reinterpret_cast<uintptr_t>(replace) - reinterpret_cast<uintptr_t>(symbol))
+                      - X64_JMP_REL32_SIZE)) {
+        target = __entry_island(symbol, replace);
+        if (target == NULL) {
+            HOOK_LOGI("no free page near %p, the entry is patched with an absolute jump", symbol);
+            target = replace;
+        } //if
+    } //if
+
+    void *trampoline = NULL;
+    if (result != NULL) {
+        // next to the symbol, so that the jump back and relocated rip-relative operands stay in rel32 reach
+        trampoline = HookAllocateNear(symbol, X64_TRAMPOLINE_SIZE, X64_NEAR_RANGE);
+        if (trampoline == NULL) {
+            HOOK_LOGI("no free page near %p, the trampoline returns with an absolute jump", symbol);
+            trampoline = HookAllocate(X64_TRAMPOLINE_SIZE);
+        } //if
+        *result    = trampoline;
+        if (trampoline == NULL) {
+            HOOK_LOGE("failed to allocate trampoline!");
+            return;
+        } //if
+    } //if
+
+    uintptr_t used   = 0;
+    void     *hooked = __hook_function_v(symbol, target, trampoline, X64_TRAMPOLINE_SIZE, &used);
+    HookShrink(trampoline, X64_TRAMPOLINE_SIZE, used);
+    if (hooked == NULL && result != NULL) {
+        *result = NULL;
+    } //if
+}
+}
+
+#endif // defined(__x86_64__)
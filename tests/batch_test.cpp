@@ -0,0 +1,75 @@
+// Checks that a batch reports patches one by one: a patch whose page cannot be made writable is left
+// unpatched and cannot be re-applied, while the other patches of the same commit take effect, and that
+// batches nest instead of dropping what an outer batch has queued until they are committed or aborted.
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "HookMemory.h"
+#include "check.h"
+
+int main() {
+    const size_t page = sysconf(_SC_PAGESIZE);
+
+    // An anonymous page can be made writable again, a shared mapping of a read-only file cannot. The middle
+    // of three pages is used, so that it is never next to the other mapping and patched in the same group.
+    auto pages = static_cast<uint8_t *>(mmap(nullptr, 3 * page, PROT_READ | PROT_WRITE,
+                                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    CHECK(pages != MAP_FAILED);
+    uint8_t *writable = pages + page;
+    memset(writable, 0x11, page);
+    mprotect(pages, 3 * page, PROT_READ);
+    int fd = open("/proc/self/exe", O_RDONLY | O_CLOEXEC);
+    auto readOnly = static_cast<uint8_t *>(mmap(nullptr, page, PROT_READ, MAP_SHARED, fd, 0));
+    CHECK(readOnly != MAP_FAILED);
+    uint8_t before[4];
+    memcpy(before, readOnly + 64, sizeof(before));
+
+    const uint8_t code[4] = {1, 2, 3, 4};
+    HookBatchBegin();
+    CHECK(HookPatchText(writable + 64, code, sizeof(code)));
+    CHECK(HookPatchText(readOnly + 64, code, sizeof(code)));
+    CHECK(!HookIsPatched(writable + 64));
+    CHECK_EQ(HookBatchCommit(nullptr), 1);
+
+    CHECK(HookIsPatched(writable + 64));
+    CHECK(memcmp(writable + 64, code, sizeof(code)) == 0);
+    CHECK(!HookIsPatched(readOnly + 64));
+    CHECK(memcmp(readOnly + 64, before, sizeof(before)) == 0);
+    CHECK(!HookSetPatched(readOnly + 64, true));
+
+    CHECK(HookSetPatched(writable + 64, false));
+    CHECK_EQ(writable[64], 0x11);
+    CHECK(HookSetPatched(writable + 64, true));
+    CHECK_EQ(writable[64], 1);
+
+    const uint8_t inner[4] = {5, 6, 7, 8};
+    HookBatchBegin();
+    CHECK(HookPatchText(writable + 128, code, sizeof(code)));
+    HookBatchBegin();
+    CHECK(HookPatchText(writable + 192, inner, sizeof(inner)));
+    CHECK_EQ(HookBatchCommit(nullptr), 0);
+    CHECK(HookBatchIsOpen());
+    CHECK(!HookIsPatched(writable + 128));
+    CHECK(!HookIsPatched(writable + 192));
+    CHECK_EQ(HookBatchCommit(nullptr), 2);
+    CHECK(!HookBatchIsOpen());
+    CHECK(memcmp(writable + 128, code, sizeof(code)) == 0);
+    CHECK(memcmp(writable + 192, inner, sizeof(inner)) == 0);
+    CHECK_EQ(HookBatchCommit(nullptr), 0);
+
+    // an aborted batch writes nothing, however deep it was nested
+    const uint8_t dropped[4] = {9, 9, 9, 9};
+    HookBatchBegin();
+    HookBatchBegin();
+    CHECK(HookPatchText(writable + 256, dropped, sizeof(dropped)));
+    HookBatchAbort();
+    CHECK(!HookBatchIsOpen());
+    CHECK_EQ(writable[256], 0x11);
+    CHECK(!HookIsPatched(writable + 256));
+
+    munmap(readOnly, page);
+    munmap(pages, 3 * page);
+    close(fd);
+    return checkFailures();
+}
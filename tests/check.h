@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdio>
+
+// Assertions of the host tests. A failed CHECK reports itself and the test goes on, so one run shows every
+// mismatch; main() returns checkFailures() and ctest reports the test as failed if any check did.
+inline int checkFailureCount = 0;
+
+#define CHECK(condition)                                                                       \
+    do {                                                                                       \
+        if (!(condition)) {                                                                    \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition);      \
+            ++checkFailureCount;                                                               \
+        }                                                                                      \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                                             \
+    do {                                                                                       \
+        auto &&checkActual = (actual);                                                         \
+        auto &&checkExpected = (expected);                                                     \
+        if (!(checkActual == checkExpected)) {                                                 \
+            fprintf(stderr, "%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, \
+                    #actual, #expected, (long long) checkActual, (long long) checkExpected);  \
+            ++checkFailureCount;                                                               \
+        }                                                                                      \
+    } while (0)
+
+inline int checkFailures() {
+    if (checkFailureCount != 0) fprintf(stderr, "%d checks failed\n", checkFailureCount);
+    return checkFailureCount == 0 ? 0 : 1;
+}
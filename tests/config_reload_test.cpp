@@ -0,0 +1,77 @@
+// Checks that a replaced gesture config is unmapped by a later watcher tick, not by sleeping in the reload: a
+// second rewrite right after the first is picked up at once, and the replaced mappings stay readable until
+// their deadline.
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <sys/mman.h>
+#include <thread>
+#include <unistd.h>
+#include "check.h"
+#include "gesture_config.h"
+#include "logger.h"
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    char dir[] = "/tmp/config_reload_test.XXXXXX";
+    char path[64];
+
+    // Writes a config with `scrollScale` next to `path` and renames it into place.
+    void writeConfig(float scrollScale) {
+        config::GestureConfig config = config::DEFAULTS;
+        config.scrollScale = scrollScale;
+        char temp[sizeof(path) + 4];
+        snprintf(temp, sizeof(temp), "%s.tmp", path);
+        FILE *file = fopen(temp, "we");
+        CHECK(file != nullptr && fwrite(&config, sizeof(config), 1, file) == 1);
+        fclose(file);
+        CHECK(rename(temp, path) == 0);
+    }
+
+    // The time until the active config has `scrollScale`, or a negative duration after two seconds.
+    Clock::duration waitFor(float scrollScale) {
+        auto start = Clock::now();
+        while (config::current().scrollScale != scrollScale) {
+            if (Clock::now() - start > std::chrono::seconds(2)) return Clock::duration(-1);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return Clock::now() - start;
+    }
+
+    bool mapped(const config::GestureConfig *config) {
+        unsigned char resident;
+        auto page = reinterpret_cast<uintptr_t>(config) & ~static_cast<uintptr_t>(getpagesize() - 1);
+        return mincore(reinterpret_cast<void *>(page), 1, &resident) == 0 || errno != ENOMEM;
+    }
+}
+
+int main() {
+    logger::disable("*");
+    CHECK(mkdtemp(dir) != nullptr);
+    snprintf(path, sizeof(path), "%s/gesture", dir);
+    writeConfig(0.3f);
+    config::watch(path);
+    const config::GestureConfig *first = &config::current();
+    CHECK(config::current().scrollScale == 0.3f);
+
+    writeConfig(0.4f);
+    CHECK(waitFor(0.4f) >= Clock::duration::zero());
+    const config::GestureConfig *second = &config::current();
+    auto replaced = Clock::now();
+    writeConfig(0.5f);
+    auto reload = waitFor(0.5f);
+    // the watcher used to sleep for a second after each reload
+    CHECK(reload >= Clock::duration::zero() && reload < std::chrono::milliseconds(500));
+    CHECK(first->scrollScale == 0.3f && second->scrollScale == 0.4f);
+
+    std::this_thread::sleep_until(replaced + std::chrono::milliseconds(1500));
+    CHECK(!mapped(first));
+    CHECK(!mapped(second));
+    CHECK(mapped(&config::current()));
+
+    unlink(path);
+    rmdir(dir);
+    return checkFailures();
+}
@@ -0,0 +1,102 @@
+// Checks GestureEngine against the handlers it was extracted from, see reference_handlers.h, on random event
+// streams. Swipes are left out of the comparison, the engine scrolls by the configured curve since.
+#include <cstdlib>
+#include "check.h"
+#include "gesture_engine.h"
+#include "logger.h"
+#include "reference_handlers.h"
+
+namespace {
+
+    constexpr int ROUNDS = 200;
+    constexpr int EVENTS = 5000;
+
+    gesture::Input randomInput(nsecs_t when) {
+        gesture::Input in{};
+        in.when = when;
+        in.mode = static_cast<PointerGestureMode>(rand() % 9);
+        in.fingerCount = rand() % 5;
+        // often enough three fingers to toggle the transform
+        if (rand() % 3 == 0) {
+            in.mode = PointerGestureMode::PRESS;
+            in.fingerCount = 3;
+        }
+        in.x = static_cast<float>(rand() % 1000);
+        in.y = static_cast<float>(rand() % 1000);
+        in.action = rand() % 12;
+        in.actionButton = rand() % 3;
+        in.buttonState = rand() % 3;
+        return in;
+    }
+
+    // the calls the hook makes for `out` of the engine
+    void callsOf(const gesture::Input &in, const gesture::Output &out, ReferenceHandlers::Calls &calls) {
+        calls.count = 0;
+        for (size_t i = 0; i < out.count; ++i) {
+            const gesture::Action &a = out.actions[i];
+            calls.calls[calls.count++] = {a.action, a.actionButton, a.buttonState, true, false, 0, 0};
+        }
+        if (!out.cancel) calls.calls[calls.count++] = {in.action, in.actionButton, in.buttonState, false, false, 0, 0};
+    }
+
+    bool sameCalls(const ReferenceHandlers::Calls &a, const ReferenceHandlers::Calls &b) {
+        if (a.count != b.count) return false;
+        for (size_t i = 0; i < a.count; ++i) {
+            const auto &x = a.calls[i], &y = b.calls[i];
+            if (x.action != y.action || x.actionButton != y.actionButton || x.buttonState != y.buttonState ||
+                x.mouse != y.mouse) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main() {
+    // thousands of toggles and right clicks
+    logger::disable("*");
+    srand(3);
+    long compared = 0, toggles = 0;
+    for (int round = 0; round < ROUNDS; ++round) {
+        ReferenceHandlers reference;
+        gesture::GestureEngine engine;
+        nsecs_t when = 0;
+        for (int event = 0; event < EVENTS; ++event) {
+            // mostly reports 8 ms apart, sometimes a pause longer than the tap timeout
+            when += (rand() % 4 == 0 ? 200 : 8) * 1000000LL;
+            gesture::Input in = randomInput(when);
+            if (in.mode == PointerGestureMode::SWIPE) in.mode = PointerGestureMode::HOVER;
+            ReferenceHandlers::Calls expected, actual;
+            reference.dispatchMotion(in, expected);
+            gesture::Output out;
+            bool wasEnabled = engine.transformEnabled();
+            engine.process(in, config::DEFAULTS, out);
+            callsOf(in, out, actual);
+            CHECK(sameCalls(actual, expected));
+            CHECK_EQ(engine.transformEnabled(), reference.enableGestureTransform);
+            toggles += wasEnabled != engine.transformEnabled();
+            ++compared;
+        }
+    }
+    CHECK(toggles > 0);
+    printf("%ld events compared, the transform toggled %ld times\n", compared, toggles);
+
+    // a swipe still holds the pointer where it started and scrolls every second report
+    gesture::GestureEngine engine;
+    gesture::Output out;
+    engine.process({0, PointerGestureMode::HOVER, 1, 100, 200, AMOTION_EVENT_ACTION_HOVER_MOVE, 0, 0},
+                   config::DEFAULTS, out);
+    size_t scrolls = 0;
+    for (int i = 1; i <= 10; ++i) {
+        engine.process({i * 8000000LL, PointerGestureMode::SWIPE, 2, 100, 200.0f - 10.0f * i,
+                        AMOTION_EVENT_ACTION_MOVE, 0, 0}, config::DEFAULTS, out);
+        if (out.scroll) {
+            ++scrolls;
+            CHECK(out.x == 100 && out.y == 200);
+            CHECK(out.hscroll > 0);
+            CHECK_EQ(out.count, 3u);
+        }
+    }
+    CHECK_EQ(scrolls, 4u);
+    return checkFailures();
+}
@@ -0,0 +1,89 @@
+// Hooks the stub libinputreader.so through the THook macros and the x86-64 backend, the way the device
+// build hooks the real one, then checks the detour, the trampoline back into the original and bypass.
+#include <thread>
+#include "check.h"
+#include "hookapi.h"
+#include "stub_inputreader.h"
+
+namespace {
+    int hookCalls = 0;
+    std::atomic<bool> blockInHook{false};
+    std::atomic<bool> inHook{false};
+}
+
+TInstanceHook(int64_t, hooks::LIBINPUT_READER, STUB_DISPATCH_MOTION, android::TouchInputMapper,
+              int64_t when, int32_t action) {
+    ++hookCalls;
+    // stands in for a hook body that takes a while to return
+    if (blockInHook.load()) {
+        inHook.store(true);
+        while (blockInHook.load()) std::this_thread::yield();
+    }
+    return original(this, when, action * 2) + 1000;
+}
+
+using DispatchHook = THookTemplate<do_hash(STUB_DISPATCH_MOTION), do_hash(hooks::LIBINPUT_READER)>;
+
+namespace {
+
+    void writeControl(const char *path, const char *value) {
+        FILE *file = fopen(path, "we");
+        fputs(value, file);
+        fclose(file);
+    }
+}
+
+int main() {
+    android::TouchInputMapper mapper;
+    CHECK(DispatchHook::_site() != hooks::UNTRACKED_SITE);
+
+    // the original runs through the trampoline with the doubled action
+    CHECK_EQ(mapper.dispatchMotion(100, 3), 100 + 6 + 1000);
+    CHECK_EQ(mapper.dispatched, 6);
+    CHECK_EQ(hookCalls, 1);
+    CHECK_EQ(hooks::threadsInside(DispatchHook::_site()), 0u);
+    CHECK_EQ(mapper.dispatchMotion(0, -1), -1 + 1000);
+    CHECK_EQ(mapper.dispatched, 0);
+
+    CHECK(hooks::setBypass(true));
+    CHECK(hooks::bypassed.load());
+    CHECK_EQ(mapper.dispatchMotion(100, 3), 103);
+    CHECK_EQ(hookCalls, 2);
+
+    CHECK(hooks::setBypass(false));
+    CHECK_EQ(mapper.dispatchMotion(100, 1), 100 + 3 + 2 + 1000);
+    CHECK_EQ(hookCalls, 3);
+
+    // the control file switches bypass on and off
+    const char *control = "hook_test.bypass";
+    writeControl(control, "1");
+    hooks::applyBypassControl(control);
+    CHECK(hooks::bypassed.load());
+    writeControl(control, "0");
+    hooks::applyBypassControl(control);
+    CHECK(!hooks::bypassed.load());
+    remove(control);
+
+    // bypass fails and leaves the hooks installed while a thread stays inside the hook body
+    blockInHook.store(true);
+    android::TouchInputMapper blocked;
+    int64_t blockedResult = 0;
+    std::thread reader([&] { blockedResult = blocked.dispatchMotion(1, 1); });
+    while (!inHook.load()) std::this_thread::yield();
+    CHECK_EQ(hooks::threadsInside(DispatchHook::_site()), 1u);
+    CHECK(!hooks::setBypass(true));
+    CHECK(!hooks::bypassed.load());
+    CHECK(A64IsHooked(hooks::hookSites[DispatchHook::_site()].address));
+    blockInHook.store(false);
+    reader.join();
+    CHECK_EQ(blockedResult, 1 + 2 + 1000);
+    CHECK_EQ(hooks::threadsInside(DispatchHook::_site()), 0u);
+    CHECK_EQ(blocked.dispatchMotion(100, 1), 100 + 2 + 2 + 1000);
+
+    // once it has left, bypass goes through
+    CHECK(hooks::setBypass(true));
+    CHECK_EQ(blocked.dispatchMotion(100, 1), 100 + 4 + 1);
+    CHECK(!A64IsHooked(hooks::hookSites[DispatchHook::_site()].address));
+    CHECK(hooks::setBypass(false));
+    return checkFailures();
+}
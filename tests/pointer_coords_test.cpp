@@ -0,0 +1,75 @@
+// Checks the inline PointerCoords::getAxisValue/setAxisValue of types.h against a model of the semantics of
+// libinput's: an ordered map of axis -> value that refuses axes outside 0..63, does not store a new axis of
+// value 0 and holds at most MAX_AXES axes. The packed values must stay in axis order, as libinput reads them.
+#include <cstdlib>
+#include <map>
+#include "check.h"
+#include "types.h"
+
+namespace {
+
+    constexpr int ROUNDS = 2000;
+    constexpr int OPERATIONS = 60;
+
+    status_t modelSet(std::map<int32_t, float> &model, int32_t axis, float value) {
+        if (axis < 0 || axis > 63) return android::NAME_NOT_FOUND;
+        if (model.count(axis) == 0) {
+            if (value == 0) return android::OK;
+            if (model.size() >= PointerCoords::MAX_AXES) return android::NO_MEMORY;
+        }
+        model[axis] = value;
+        return android::OK;
+    }
+
+    void checkLayout(const PointerCoords &coords, const std::map<int32_t, float> &model) {
+        CHECK_EQ(android::BitSet64::count(coords.bits), model.size());
+        size_t index = 0;
+        for (auto [axis, value]: model) {
+            CHECK(android::BitSet64::hasBit(coords.bits, axis));
+            CHECK(coords.values[index++] == value);
+        }
+    }
+}
+
+int main() {
+    PointerCoords coords{};
+    CHECK_EQ(coords.setAxisValue(-1, 1), android::NAME_NOT_FOUND);
+    CHECK_EQ(coords.setAxisValue(64, 1), android::NAME_NOT_FOUND);
+    CHECK(coords.getAxisValue(-1) == 0 && coords.getAxisValue(64) == 0);
+    CHECK_EQ(coords.setAxisValue(AMOTION_EVENT_AXIS_X, 0), android::OK);
+    CHECK_EQ(coords.bits, 0u);
+    CHECK_EQ(coords.setAxisValue(AMOTION_EVENT_AXIS_Y, 2), android::OK);
+    CHECK_EQ(coords.setAxisValue(AMOTION_EVENT_AXIS_X, 1), android::OK);
+    CHECK(coords.values[0] == 1 && coords.values[1] == 2);
+    // a stored axis keeps its slot when set to 0
+    CHECK_EQ(coords.setAxisValue(AMOTION_EVENT_AXIS_X, 0), android::OK);
+    CHECK(android::BitSet64::hasBit(coords.bits, AMOTION_EVENT_AXIS_X) && coords.getAxisValue(AMOTION_EVENT_AXIS_X) == 0);
+
+    coords = {};
+    for (int32_t axis = 0; axis < PointerCoords::MAX_AXES; ++axis) {
+        CHECK_EQ(coords.setAxisValue(axis, 1), android::OK);
+    }
+    CHECK_EQ(coords.setAxisValue(PointerCoords::MAX_AXES, 1), android::NO_MEMORY);
+    CHECK_EQ(coords.setAxisValue(PointerCoords::MAX_AXES, 0), android::OK);
+    CHECK_EQ(coords.setAxisValue(0, 5), android::OK);
+    CHECK(coords.getAxisValue(PointerCoords::MAX_AXES) == 0 && coords.getAxisValue(0) == 5);
+
+    srand(7);
+    for (int round = 0; round < ROUNDS; ++round) {
+        coords = {};
+        std::map<int32_t, float> model;
+        for (int operation = 0; operation < OPERATIONS; ++operation) {
+            int32_t axis = rand() % 70 - 3;
+            float value = rand() % 4 == 0 ? 0.0f : static_cast<float>(rand() % 1000);
+            if (rand() & 1) {
+                CHECK_EQ(coords.setAxisValue(axis, value), modelSet(model, axis, value));
+            } else {
+                auto stored = model.find(axis);
+                CHECK(coords.getAxisValue(axis) == (stored == model.end() ? 0.0f : stored->second));
+            }
+        }
+        checkLayout(coords, model);
+        CHECK(!coords.isResampled);
+    }
+    return checkFailures();
+}
@@ -0,0 +1,104 @@
+// Checks which events make it into a recording: one queued right after recording was turned on is kept, even
+// though the flush thread only opens the recording later, and one read before that is left out. Turning it off
+// and on again faster than the flush thread looks starts a new recording all the same.
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <thread>
+#include <unistd.h>
+#include "check.h"
+#include "logger.h"
+#include "motion_recorder.h"
+
+namespace {
+
+    void writeControl(const char *value) {
+        FILE *file = fopen(INPUT_INJECT_RECORD_CONTROL_PATH, "we");
+        CHECK(file != nullptr);
+        fputs(value, file);
+        fclose(file);
+    }
+
+    nsecs_t monotonicNow() {
+        timespec ts{};
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    }
+
+    // Waits for the control file watcher to apply the last write.
+    void waitRecording(bool on) {
+        for (int i = 0; i < 500 && recorder::recording() != on; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        CHECK(recorder::recording() == on);
+    }
+
+    recorder::Event event(nsecs_t when, nsecs_t readTime) {
+        recorder::Event e{};
+        e.when = when;
+        e.readTime = readTime;
+        e.deviceId = 7;
+        e.action = AMOTION_EVENT_ACTION_MOVE;
+        e.mode = PointerGestureMode::SWIPE;
+        e.fingerCount = 2;
+        e.pointerCount = 1;
+        e.idBits = 1u << 31;
+        return e;
+    }
+
+    // The lines of the recording that are events, not comments.
+    int eventLines(char lines[][256], int max) {
+        FILE *file = fopen(INPUT_INJECT_RECORDING_PATH, "re");
+        if (file == nullptr) return 0;
+        int count = 0;
+        char line[256];
+        while (count < max && fgets(line, sizeof(line), file) != nullptr) {
+            if (line[0] != '#') strcpy(lines[count++], line);
+        }
+        fclose(file);
+        return count;
+    }
+}
+
+int main() {
+    logger::disable("*");
+    unlink(INPUT_INJECT_RECORDING_PATH);
+    writeControl("1");
+    recorder::watch(INPUT_INJECT_RECORD_CONTROL_PATH);
+    CHECK(recorder::recording());
+
+    nsecs_t now = monotonicNow();
+    // read long before recording was asked for, as if left over from an earlier recording
+    recorder::record(event(1, now - 1000000000LL));
+    // read after it was asked for, most likely before the flush thread got to open the recording
+    recorder::record(event(2, now));
+
+    char lines[4][256];
+    int count = 0;
+    for (int i = 0; i < 100 && count == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        count = eventLines(lines, 4);
+    }
+    CHECK_EQ(count, 1);
+    CHECK(count >= 1 && strncmp(lines[0], "2 ", 2) == 0);
+
+    // off and on again well within one flush interval, the next event goes to a new recording
+    writeControl("0");
+    waitRecording(false);
+    writeControl("1");
+    waitRecording(true);
+    recorder::record(event(3, monotonicNow()));
+    count = 0;
+    for (int i = 0; i < 100 && !(count == 1 && strncmp(lines[0], "3 ", 2) == 0); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        count = eventLines(lines, 4);
+    }
+    CHECK_EQ(count, 1);
+    CHECK(count >= 1 && strncmp(lines[0], "3 ", 2) == 0);
+
+    writeControl("0");
+    waitRecording(false);
+    unlink(INPUT_INJECT_RECORD_CONTROL_PATH);
+    unlink(INPUT_INJECT_RECORDING_PATH);
+    return checkFailures();
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include "gesture_engine.h"
+
+// The touchpad gesture transform as the dispatchMotion hook of hooks.cpp did it before GestureEngine: the
+// handlers in the order the hook ran them, each deciding on its own whether the original event is dropped, with
+// the function statics they kept as members. A swipe scrolls by the old stepped speed of each report's delta,
+// everything else is what the engine must still do.
+struct ReferenceHandlers {
+    struct Call {
+        int32_t action;
+        int32_t actionButton;
+        int32_t buttonState;
+        bool mouse;   // dispatched with the tool type of pointer 0 set to MOUSE
+        bool scroll;  // after the scroll axes were set
+        float vscroll, hscroll;
+    };
+
+    // what the hook passed to the original dispatchMotion for one event
+    struct Calls {
+        Call calls[gesture::Output::MAX_ACTIONS + 1];
+        size_t count;
+    };
+
+    PointerGestureMode lastGesture = PointerGestureMode::NEUTRAL;
+    bool enableGestureTransform = true;
+    // handleModeSwitch
+    uint32_t switchFingerCount = 0;
+    nsecs_t switchPressTime = 0;
+    size_t tripleTapCounter = 0;
+    nsecs_t lastTripleTapTime = 0;
+    // handlePressGesture
+    uint32_t pressFingerCount = 0;
+    nsecs_t pressTime = 0;
+    // handleSwipeGesture
+    float lastX = 0, lastY = 0, swipeX = 0, swipeY = 0;
+    size_t counter = 0;
+    float speedSumX = 0, speedSumY = 0;
+
+    void dispatchMotion(const gesture::Input &in, Calls &out) {
+        using M = PointerGestureMode;
+        const M curr = in.mode;
+        out.count = 0;
+        bool scrolled = false;
+        float vscroll = 0, hscroll = 0;
+        auto original = [&](int32_t action, int32_t actionButton, int32_t buttonState, bool mouse) {
+            out.calls[out.count++] = {action, actionButton, buttonState, mouse, scrolled, vscroll, hscroll};
+        };
+
+        auto handleModeSwitch = [&] {
+            if (curr == M::PRESS) {
+                switchFingerCount = in.fingerCount;
+                switchPressTime = in.when;
+            }
+            if ((curr == M::NEUTRAL || curr == M::QUIET) && lastGesture == M::PRESS && switchFingerCount == 3 &&
+                in.when - switchPressTime <= 150 * 1000000LL) {
+                tripleTapCounter++;
+                if (in.when - lastTripleTapTime <= 1500 * 1000000LL) {
+                    if (tripleTapCounter >= 3) {
+                        enableGestureTransform = !enableGestureTransform;
+                        tripleTapCounter = 0;
+                    }
+                } else {
+                    tripleTapCounter = 1;
+                }
+                lastTripleTapTime = in.when;
+            }
+        };
+
+        auto handleTapGesture = [&]() -> bool {
+            if (curr == M::TAP) {
+                original(AMOTION_EVENT_ACTION_DOWN, 0, AMOTION_EVENT_BUTTON_PRIMARY, true);
+                original(AMOTION_EVENT_ACTION_BUTTON_PRESS, AMOTION_EVENT_BUTTON_PRIMARY, AMOTION_EVENT_BUTTON_PRIMARY,
+                         true);
+                return false;
+            }
+            if (curr == M::NEUTRAL && (lastGesture == M::TAP_DRAG || lastGesture == M::TAP)) {
+                original(AMOTION_EVENT_ACTION_BUTTON_RELEASE, AMOTION_EVENT_BUTTON_PRIMARY, 0, true);
+                original(AMOTION_EVENT_ACTION_UP, 0, 0, true);
+                return true;
+            }
+            return false;
+        };
+
+        auto handleBtnClickDragGesture = [&]() -> bool {
+            if (curr == M::BUTTON_CLICK_OR_DRAG && lastGesture != M::BUTTON_CLICK_OR_DRAG) {
+                original(AMOTION_EVENT_ACTION_DOWN, 0, AMOTION_EVENT_BUTTON_PRIMARY, true);
+                original(AMOTION_EVENT_ACTION_BUTTON_PRESS, AMOTION_EVENT_BUTTON_PRIMARY, AMOTION_EVENT_BUTTON_PRIMARY,
+                         true);
+                return true;
+            }
+            if (curr == M::HOVER && lastGesture == M::BUTTON_CLICK_OR_DRAG) {
+                original(AMOTION_EVENT_ACTION_BUTTON_RELEASE, AMOTION_EVENT_BUTTON_PRIMARY, 0, true);
+                original(AMOTION_EVENT_ACTION_UP, 0, 0, true);
+                return true;
+            }
+            original(in.action, AMOTION_EVENT_BUTTON_PRIMARY, AMOTION_EVENT_BUTTON_PRIMARY, true);
+            return true;
+        };
+
+        auto handlePressGesture = [&]() -> bool {
+            if (curr == M::PRESS) {
+                pressFingerCount = in.fingerCount;
+                pressTime = in.when;
+                return true;
+            }
+            if ((curr == M::NEUTRAL || curr == M::QUIET) && lastGesture == M::PRESS && pressFingerCount == 2) {
+                if (in.when - pressTime <= 150 * 1000000LL) {
+                    original(AMOTION_EVENT_ACTION_DOWN, 0, AMOTION_EVENT_BUTTON_SECONDARY, true);
+                    original(AMOTION_EVENT_ACTION_BUTTON_PRESS, AMOTION_EVENT_BUTTON_SECONDARY,
+                             AMOTION_EVENT_BUTTON_SECONDARY, true);
+                    original(AMOTION_EVENT_ACTION_BUTTON_RELEASE, AMOTION_EVENT_BUTTON_SECONDARY, 0, true);
+                    original(AMOTION_EVENT_ACTION_UP, 0, 0, true);
+                }
+                return true;
+            }
+            return false;
+        };
+
+        auto handleSwipeGesture = [&]() -> bool {
+            float diffX = lastX - in.x, diffY = lastY - in.y;
+            bool handled = false;
+            if (curr == M::SWIPE) {
+                auto speedTransform = [](float speed) -> float {
+                    float s = std::fabs(speed);
+                    float sign = speed > 0 ? 1.0f : -1.0f;
+                    if (s < 0.2) return 0;
+                    if (s < 0.5) return sign * (s * 1.1f);
+                    if (s < 2) return sign * (s * 1.25f);
+                    if (s > 80) return sign * 8.0f;
+                    return sign * 2.5f;
+                };
+                if (lastGesture != M::SWIPE) {
+                    swipeX = lastX;
+                    swipeY = lastY;
+                } else {
+                    counter++;
+                    speedSumX += speedTransform(diffX);
+                    speedSumY += speedTransform(diffY);
+                    if (counter >= 2) {
+                        scrolled = true;
+                        vscroll = speedSumX * 0.2f;
+                        hscroll = speedSumY * 0.2f;
+                        original(AMOTION_EVENT_ACTION_HOVER_MOVE, in.actionButton, in.buttonState, true);
+                        original(AMOTION_EVENT_ACTION_SCROLL, in.actionButton, in.buttonState, true);
+                        counter = 0;
+                        speedSumX = 0;
+                        speedSumY = 0;
+                    }
+                }
+                handled = true;
+            }
+            lastX = in.x;
+            lastY = in.y;
+            return handled;
+        };
+
+        bool cancel = false;
+        if (enableGestureTransform) {
+            cancel = handlePressGesture() || cancel;
+            cancel = handleSwipeGesture() || cancel;
+            cancel = handleTapGesture() || cancel;
+            cancel = handleBtnClickDragGesture() || cancel;
+        }
+        handleModeSwitch();
+        lastGesture = curr;
+        if (!cancel) original(in.action, in.actionButton, in.buttonState, false);
+    }
+};
@@ -0,0 +1,61 @@
+// Checks that the resolver and the pattern scanner do not trust a cached address that no longer fits the
+// module: both look the symbol up again and repair the cache entry.
+#include <cstring>
+#include <dlfcn.h>
+#include "check.h"
+#include "pattern_scanner.h"
+#include "stub_inputreader.h"
+#include "symbol_cache.h"
+#include "symbol_resolver.h"
+
+namespace {
+
+    constexpr const char *MODULE = "libinputreader.so";
+
+    // The first `size` bytes of `p` as a pattern.
+    void patternOf(const void *p, size_t size, char *text) {
+        auto bytes = static_cast<const uint8_t *>(p);
+        for (size_t i = 0; i < size; ++i) {
+            snprintf(text + i * 3, 4, "%02X ", bytes[i]);
+        }
+        text[size * 3 - 1] = '\0';
+    }
+}
+
+int main() {
+    // also keeps the stub library linked, nothing else here refers to it by symbol
+    delete android::KeyboardInputMapper::create();
+    void *handle = dlopen(MODULE, RTLD_NOW | RTLD_NOLOAD);
+    void *dispatch = dlsym(handle, STUB_DISPATCH_MOTION);
+    void *vtable = dlsym(handle, STUB_KEYBOARD_VTABLE);
+    CHECK(dispatch != nullptr && vtable != nullptr);
+    uint64_t buildKey = resolver::buildKey(MODULE);
+    CHECK(buildKey != 0);
+    auto base = reinterpret_cast<uintptr_t>(dispatch);
+
+    CHECK(resolver::findSymbol(MODULE, STUB_DISPATCH_MOTION) == dispatch);
+    CHECK(resolver::findSymbol(MODULE, STUB_KEYBOARD_VTABLE, resolver::SymbolKind::DATA) == vtable);
+
+    // far outside of the module
+    symcache::put(buildKey, STUB_DISPATCH_MOTION, 1ull << 40);
+    CHECK(resolver::findSymbol(MODULE, STUB_DISPATCH_MOTION) == dispatch);
+    uint64_t rva = 0;
+    CHECK(symcache::get(buildKey, STUB_DISPATCH_MOTION, &rva));
+    CHECK(rva != 1ull << 40);
+    CHECK(resolver::findSymbol(MODULE, STUB_DISPATCH_MOTION) == dispatch);
+
+    // a function must be in an executable segment, the vtable is not
+    symcache::put(buildKey, STUB_DISPATCH_MOTION, reinterpret_cast<uintptr_t>(vtable) - (base - rva));
+    CHECK(resolver::findSymbol(MODULE, STUB_DISPATCH_MOTION) == dispatch);
+    CHECK(resolver::findSymbol(MODULE, STUB_KEYBOARD_VTABLE, resolver::SymbolKind::DATA) == vtable);
+
+    char pattern[16 * 3];
+    patternOf(dispatch, 16, pattern);
+    CHECK(scanner::findUnique(MODULE, pattern) == dispatch);
+    // inside the text, but the bytes there differ
+    symcache::put(buildKey, pattern, rva + 1);
+    CHECK(scanner::findUnique(MODULE, pattern) == dispatch);
+    CHECK(symcache::get(buildKey, pattern, &rva));
+    CHECK(scanner::findUnique(MODULE, pattern) == dispatch);
+    return checkFailures();
+}
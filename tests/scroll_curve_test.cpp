@@ -0,0 +1,79 @@
+// Pins the default scroll curve to the per-event speed transform it replaced, at the 120 Hz report rate the
+// curve was derived for. The old transform took the finger's movement of one report and returned scroll units
+// for that report, the curve takes px/ms and returns units per ms. The two deliberately differ where the old
+// steps became ramps, see DEFAULT_CURVE, everywhere else they must agree.
+#include <cmath>
+#include "check.h"
+#include "gesture_engine.h"
+
+namespace {
+
+    // the speedTransform of the old handleSwipeGesture
+    float oldSpeed(float speed) {
+        float s = std::fabs(speed);
+        float sign = speed > 0 ? 1.0f : -1.0f;
+        if (s < 0.2) return 0;
+        if (s < 0.5) return sign * (s * 1.1f);
+        if (s < 2) return sign * (s * 1.25f);
+        if (s > 80) return sign * 8.0f;
+        return sign * 2.5f;
+    }
+
+    // the new curve in units per report of `delta` px
+    float newSpeed(float delta) {
+        return gesture::scrollSpeed(delta / config::REPORT_PERIOD_MS, config::DEFAULTS) * config::REPORT_PERIOD_MS;
+    }
+
+    // below 0.5 px the old 1.1 gain started with a step from 0 to 0.22 units at 0.2 px, now it is a ramp from 0
+    bool inLowRamp(float delta) {
+        return delta >= 0.2f && delta < 0.5f;
+    }
+
+    // above 60 px the old 2.5 units jumped to 8 at 80 px, now they rise evenly to 8 at 100 px
+    bool inHighRamp(float delta) {
+        return delta >= 60.0f && delta <= 100.0f;
+    }
+
+    // the sampled curve is off the piecewise linear one near the kinks between its points
+    constexpr float TOLERANCE = 0.12f;
+}
+
+int main() {
+    float worst = 0, worstAt = 0;
+    for (int i = 0; i <= 200000; ++i) {
+        float delta = static_cast<float>(i) * 150.0f / 200000;
+        for (float d : {delta, -delta}) {
+            float speed = newSpeed(d);
+            CHECK(std::isfinite(speed));
+            CHECK(d == 0 || speed == 0 || std::signbit(speed) == std::signbit(d));
+            if (inLowRamp(delta)) {
+                float ramp = 0.55f * (delta - 0.2f) / 0.3f;
+                CHECK(std::fabs(std::fabs(speed) - ramp) <= TOLERANCE);
+            } else if (inHighRamp(delta)) {
+                float ramp = 2.5f + (8.0f - 2.5f) * (delta - 60.0f) / 40.0f;
+                CHECK(std::fabs(std::fabs(speed) - ramp) <= TOLERANCE);
+            } else {
+                float error = std::fabs(speed - oldSpeed(d));
+                if (error > worst) {
+                    worst = error;
+                    worstAt = d;
+                }
+                CHECK(error <= TOLERANCE);
+            }
+        }
+    }
+    printf("largest difference to the old transform outside the ramps: %.4f units at %.3f px per report\n", worst,
+           worstAt);
+
+    // monotonic in the speed of the fingers, flat past the end of the curve
+    float last = 0;
+    for (int i = 0; i <= 20000; ++i) {
+        float speed = newSpeed(static_cast<float>(i) * 0.01f);
+        CHECK(speed >= last - 1e-4f);
+        last = speed;
+    }
+    CHECK(std::fabs(newSpeed(100.0f) - 8.0f) < 1e-3f);
+    CHECK(newSpeed(1000.0f) == newSpeed(100.0f));
+    CHECK(newSpeed(0.1f) == 0);
+    return checkFailures();
+}
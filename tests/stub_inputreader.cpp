@@ -0,0 +1,25 @@
+#include "stub_inputreader.h"
+
+namespace android {
+
+    // long enough for either jump the x86-64 backend patches in, without running into the next function
+    int64_t TouchInputMapper::dispatchMotion(int64_t when, int32_t action) {
+        if (action < 0) {
+            dispatched = 0;
+            return -1;
+        }
+        dispatched += action;
+        return when + dispatched;
+    }
+
+    KeyboardInputMapper::~KeyboardInputMapper() = default;
+
+    int64_t KeyboardInputMapper::reset(int64_t when) {
+        ++resets;
+        return when;
+    }
+
+    KeyboardInputMapper *KeyboardInputMapper::create() {
+        return new KeyboardInputMapper;
+    }
+}
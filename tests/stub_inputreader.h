@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+// Stand-in for the part of libinputreader.so that the host tests and benchmarks hook. It is built as a shared
+// library of that name, so hooks find it by module and symbol name the same way they do on the device.
+namespace android {
+
+    class TouchInputMapper {
+    public:
+        int64_t dispatched = 0;
+
+        int64_t dispatchMotion(int64_t when, int32_t action);
+    };
+
+    // A mapper with a vtable, for hooking virtual functions of single objects. Objects are only made by the
+    // library, so they use the library's own vtable like on the device.
+    class KeyboardInputMapper {
+    public:
+        int64_t resets = 0;
+
+        virtual ~KeyboardInputMapper();
+
+        virtual int64_t reset(int64_t when);
+
+        static KeyboardInputMapper *create();
+    };
+}
+
+#define STUB_DISPATCH_MOTION "_ZN7android16TouchInputMapper14dispatchMotionEli"
+#define STUB_KEYBOARD_VTABLE "_ZTVN7android19KeyboardInputMapperE"
+#define STUB_KEYBOARD_RESET "_ZN7android19KeyboardInputMapper5resetEl"
@@ -0,0 +1,60 @@
+// Checks that VelocityTracker measures px/ms whatever the report rate, that it smooths jittered timestamps,
+// and that it only looks at the current movement.
+#include <cmath>
+#include <cstdlib>
+#include "check.h"
+#include "velocity_tracker.h"
+
+namespace {
+
+    // px/ms of a swipe that moves (0.7, -0.4) px/ms, sampled every `period` ns for 200 ms
+    void checkRate(nsecs_t period) {
+        VelocityTracker tracker;
+        for (nsecs_t t = 0; t <= 200 * 1000000LL; t += period) {
+            float ms = static_cast<float>(t) * 1e-6f;
+            tracker.add(t, 100 + 0.7f * ms, 500 - 0.4f * ms);
+        }
+        float vx = 0, vy = 0;
+        CHECK(tracker.velocity(&vx, &vy));
+        CHECK(std::fabs(vx - 0.7f) < 1e-3f);
+        CHECK(std::fabs(vy + 0.4f) < 1e-3f);
+    }
+}
+
+int main() {
+    for (int hz : {60, 90, 120, 240, 480}) {
+        checkRate(1000000000LL / hz);
+    }
+
+    // batching moves the timestamps by up to 2 ms while the fingers move on evenly
+    srand(11);
+    VelocityTracker jittered;
+    for (int i = 0; i <= 30; ++i) {
+        nsecs_t t = i * 8333333LL;
+        float ms = static_cast<float>(t) * 1e-6f;
+        nsecs_t reported = t + (rand() % 4000001) - 2000000;
+        jittered.add(reported, 2.0f * ms, 0);
+    }
+    float vx = 0, vy = 0;
+    CHECK(jittered.velocity(&vx, &vy));
+    CHECK(std::fabs(vx - 2.0f) < 0.2f);
+
+    VelocityTracker tracker;
+    CHECK(!tracker.velocity(&vx, &vy));
+    tracker.add(0, 0, 0);
+    CHECK(!tracker.velocity(&vx, &vy));
+    // a fast movement, a pause longer than ASSUME_STOPPED, then a slow one: only the slow one counts
+    for (int i = 1; i <= 5; ++i) tracker.add(i * 8000000LL, 10.0f * i, 0);
+    nsecs_t resumed = 5 * 8000000LL + VelocityTracker::ASSUME_STOPPED + 1;
+    for (int i = 0; i < 5; ++i) tracker.add(resumed + i * 8000000LL, 50.0f + 0.8f * i, 0);
+    CHECK(tracker.velocity(&vx, &vy));
+    CHECK(std::fabs(vx - 0.1f) < 1e-3f);
+    // samples older than HORIZON are ignored
+    VelocityTracker horizon;
+    for (int i = 0; i < 16; ++i) horizon.add(i * 30000000LL, i < 12 ? 0.0f : 3.0f * (i - 11) * 30, 0);
+    CHECK(horizon.velocity(&vx, &vy));
+    CHECK(std::fabs(vx - 3.0f) < 1e-3f);
+    tracker.clear();
+    CHECK(!tracker.velocity(&vx, &vy));
+    return checkFailures();
+}
@@ -0,0 +1,38 @@
+// Finds a virtual function's slot through the symbols of the stub libinputreader.so and redirects it for
+// one object only.
+#include "check.h"
+#include "stub_inputreader.h"
+#include "vtable_hook.h"
+
+namespace {
+
+    VTableHook keyboardVTable;
+    int64_t (*resetOriginal)(android::KeyboardInputMapper *, int64_t);
+
+    int64_t resetHook(android::KeyboardInputMapper *mapper, int64_t when) {
+        return resetOriginal(mapper, when) + 1000;
+    }
+}
+
+int main() {
+    // D1 and D0 come first
+    int slot = VTableHook::slotOf("libinputreader.so", STUB_KEYBOARD_VTABLE, STUB_KEYBOARD_RESET);
+    CHECK_EQ(slot, 2);
+    CHECK_EQ(VTableHook::slotOf("libinputreader.so", STUB_KEYBOARD_VTABLE, "_ZN7android19KeyboardInputMapper1xEv"), -1);
+
+    android::KeyboardInputMapper *hooked = android::KeyboardInputMapper::create();
+    android::KeyboardInputMapper *stock = android::KeyboardInputMapper::create();
+    keyboardVTable.redirect(slot, reinterpret_cast<void *>(&resetHook), reinterpret_cast<void **>(&resetOriginal));
+    CHECK(keyboardVTable.attach(hooked));
+    CHECK(keyboardVTable.owns(hooked));
+    CHECK(!keyboardVTable.owns(stock));
+
+    CHECK_EQ(hooked->reset(5), 1005);
+    CHECK_EQ(hooked->resets, 1);
+    CHECK_EQ(stock->reset(5), 5);
+    CHECK_EQ(stock->resets, 1);
+
+    delete hooked;
+    delete stock;
+    return checkFailures();
+}
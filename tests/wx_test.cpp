@@ -0,0 +1,62 @@
+// Checks that installing, bypassing and reinstalling hooks leaves no mapping both writable and executable:
+// trampolines are written through their RW alias and patched pages are put back to R-X.
+#include <cstring>
+#include "check.h"
+#include "hookapi.h"
+#include "stub_inputreader.h"
+
+TInstanceHook(int64_t, hooks::LIBINPUT_READER, STUB_DISPATCH_MOTION, android::TouchInputMapper,
+              int64_t when, int32_t action) {
+    return original(this, when, action) + 1;
+}
+
+namespace {
+
+    __attribute__((noinline)) int64_t scaled(int64_t value) {
+        asm volatile("");
+        return value * 3 + 1;
+    }
+
+    int64_t (*scaledOriginal)(int64_t);
+
+    int64_t scaledHook(int64_t value) {
+        return scaledOriginal(value) + 1;
+    }
+
+    // Number of mappings of this process with both the w and x permission, each reported on stderr.
+    int writableExecutable(const char *when) {
+        FILE *maps = fopen("/proc/self/maps", "re");
+        if (maps == nullptr) return -1;
+        int found = 0;
+        char line[512];
+        while (fgets(line, sizeof(line), maps) != nullptr) {
+            char perms[5] = {};
+            if (sscanf(line, "%*s %4s", perms) == 1 && perms[1] == 'w' && perms[2] == 'x') {
+                fprintf(stderr, "%s: %s", when, line);
+                ++found;
+            }
+        }
+        fclose(maps);
+        return found;
+    }
+}
+
+int main() {
+    android::TouchInputMapper mapper;
+    CHECK_EQ(mapper.dispatchMotion(0, 1), 2);
+    CHECK_EQ(writableExecutable("after THookRegister"), 0);
+
+    A64HookBegin();
+    A64HookFunction(reinterpret_cast<void *>(&scaled), reinterpret_cast<void *>(&scaledHook),
+                    reinterpret_cast<void **>(&scaledOriginal));
+    CHECK(scaledOriginal != nullptr);
+    CHECK_EQ(A64HookCommit(nullptr), 1);
+    CHECK_EQ(scaled(1), 5);
+    CHECK_EQ(writableExecutable("after a batch"), 0);
+
+    hooks::setBypass(true);
+    CHECK_EQ(writableExecutable("after bypass"), 0);
+    hooks::setBypass(false);
+    CHECK_EQ(writableExecutable("after reinstall"), 0);
+    return checkFailures();
+}